@@ -0,0 +1,71 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+#include <fsl/estimation/cache.hpp>
+
+BOOST_AUTO_TEST_SUITE(cache)
+
+using namespace Fsl::Estimation;
+
+BOOST_AUTO_TEST_CASE(lru){
+    Cache<double> cache(2);
+    double result = 0;
+
+    BOOST_CHECK(not cache.find({1,2},result));
+    cache.insert({1,2},-1);
+    cache.insert({3,4},-2);
+    BOOST_CHECK(cache.find({1,2},result));
+    BOOST_CHECK_EQUAL(result,-1);
+
+    // {3,4} is least recently used so is evicted
+    cache.insert({5,6},-3);
+    BOOST_CHECK_EQUAL(cache.size(),2u);
+    BOOST_CHECK(not cache.find({3,4},result));
+    BOOST_CHECK(cache.find({5,6},result));
+    BOOST_CHECK(cache.find({1,2},result));
+
+    BOOST_CHECK_EQUAL(cache.hits(),3u);
+    BOOST_CHECK_EQUAL(cache.misses(),2u);
+    BOOST_CHECK_CLOSE(cache.rate(),0.6,1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(bitwise){
+    Cache<double> cache(10);
+    double result = 0;
+
+    cache.insert({0.0,NAN},1);
+    BOOST_CHECK(cache.find({0.0,NAN},result));
+    BOOST_CHECK(not cache.find({-0.0,NAN},result));
+    BOOST_CHECK(not cache.find({0.0},result));
+    BOOST_CHECK(not cache.find({0.1+0.2,NAN},result));
+
+    // Disabled cache never finds
+    Cache<double> disabled;
+    disabled.insert({1},1);
+    BOOST_CHECK(not disabled.find({1},result));
+    BOOST_CHECK_EQUAL(disabled.size(),0u);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent){
+    // Lookups and insertions while capacity is changed, including to zero
+    Cache<double> cache(100);
+    std::vector<std::thread> threads;
+    for(unsigned int thread=0;thread<4;thread++){
+        threads.emplace_back([&cache,thread](){
+            double result;
+            for(unsigned int index=0;index<10000;index++){
+                std::vector<double> key = {double(index%150),double(thread)};
+                if(not cache.find(key,result)) cache.insert(key,index);
+            }
+        });
+    }
+    for(unsigned int index=0;index<1000;index++) cache.capacity(index%3==0?0:50+index%100);
+    for(auto& thread : threads) thread.join();
+    BOOST_CHECK(cache.size()<=cache.capacity());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Fsl {
+namespace Estimation {
+
+/**
+ * A bounded cache of results (e.g. likelihoods) keyed by parameter vectors
+ *
+ * Keys are compared bitwise, so a vector only hits if every value is identical to
+ * one previously evaluated (`0.0` and `-0.0` are different keys, a `NaN` matches
+ * the same `NaN`). When the cache is full the least recently used entry is evicted.
+ * All methods are safe to call concurrently. A `capacity` of zero (the default)
+ * disables the cache.
+ */
+template<
+    class Result = double
+>
+class Cache {
+public:
+
+    Cache(unsigned int capacity = 0):
+        capacity_(capacity){
+    }
+
+    /**
+     * Copies have the same capacity but are empty
+     */
+    Cache(const Cache& other):
+        capacity_(other.capacity_.load()){
+    }
+
+    Cache& operator=(const Cache& other){
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = other.capacity_.load();
+        clear_();
+        return *this;
+    }
+
+    unsigned int capacity(void) const {
+        return capacity_;
+    }
+
+    /**
+     * Set the maximum number of entries, evicting entries if necessary
+     */
+    Cache& capacity(unsigned int capacity){
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        while(entries_.size()>capacity_) evict_();
+        return *this;
+    }
+
+    bool enabled(void) const {
+        return capacity_>0;
+    }
+
+    unsigned int size(void) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    /**
+     * Number of lookups which did, and did not, find an entry
+     */
+    unsigned long hits(void) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hits_;
+    }
+
+    unsigned long misses(void) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return misses_;
+    }
+
+    /**
+     * Proportion of lookups which found an entry
+     */
+    double rate(void) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unsigned long lookups = hits_+misses_;
+        return lookups>0?hits_/double(lookups):NAN;
+    }
+
+    /**
+     * Find the result for a key
+     *
+     * @returns Whether or not an entry was found (in which case `result` is set to it)
+     */
+    bool find(const std::vector<double>& key, Result& result){
+        // Avoid locking if disabled
+        if(capacity_==0) return false;
+        std::lock_guard<std::mutex> lock(mutex_);
+        if(capacity_==0) return false;
+        auto iter = index_.find(key);
+        if(iter==index_.end()){
+            misses_++;
+            return false;
+        }
+        // Move to front as most recently used
+        entries_.splice(entries_.begin(),entries_,iter->second);
+        result = iter->second->second;
+        hits_++;
+        return true;
+    }
+
+    /**
+     * Insert, or update, the result for a key
+     */
+    Cache& insert(const std::vector<double>& key, const Result& result){
+        if(capacity_==0) return *this;
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Capacity may have been changed since the check above
+        if(capacity_==0) return *this;
+        auto iter = index_.find(key);
+        if(iter!=index_.end()){
+            iter->second->second = result;
+            entries_.splice(entries_.begin(),entries_,iter->second);
+            return *this;
+        }
+        if(entries_.size()>=capacity_) evict_();
+        entries_.emplace_front(key,result);
+        index_.emplace(entries_.front().first,entries_.begin());
+        return *this;
+    }
+
+    /**
+     * Remove all entries and reset counts of hits and misses
+     */
+    Cache& clear(void){
+        std::lock_guard<std::mutex> lock(mutex_);
+        clear_();
+        return *this;
+    }
+
+private:
+
+    typedef std::list<std::pair<std::vector<double>,Result>> Entries;
+
+    /**
+     * Hash of the bits of values
+     */
+    struct Hash_ {
+        std::size_t operator()(const std::vector<double>& key) const {
+            uint64_t hash = 0x9e3779b97f4a7c15ull ^ key.size();
+            for(double value : key){
+                uint64_t bits;
+                std::memcpy(&bits,&value,sizeof(bits));
+                hash ^= bits + 0x9e3779b97f4a7c15ull + (hash<<6) + (hash>>2);
+                hash ^= hash>>31;
+                hash *= 0xbf58476d1ce4e5b9ull;
+            }
+            return hash ^ (hash>>29);
+        }
+    };
+
+    /**
+     * Bitwise equality of values
+     */
+    struct Equal_ {
+        bool operator()(const std::vector<double>& a, const std::vector<double>& b) const {
+            return a.size()==b.size() and std::memcmp(a.data(),b.data(),a.size()*sizeof(double))==0;
+        }
+    };
+
+    /**
+     * Atomic so that it can be checked without locking, but
+     * only changed while locked
+     */
+    std::atomic<unsigned int> capacity_;
+    unsigned long hits_ = 0;
+    unsigned long misses_ = 0;
+    Entries entries_;
+    // Keys refer to the vectors in `entries_` so are not duplicated
+    std::unordered_map<std::reference_wrapper<const std::vector<double>>,typename Entries::iterator,Hash_,Equal_> index_;
+    mutable std::mutex mutex_;
+
+    void evict_(void){
+        if(entries_.empty()) return;
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+
+    void clear_(void){
+        index_.clear();
+        entries_.clear();
+        hits_ = 0;
+        misses_ = 0;
+    }
+};
+
+} // namespace Estimation
+} // namespace Fsl
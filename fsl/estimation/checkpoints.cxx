@@ -0,0 +1,98 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+
+#include <fsl/parallel.hpp>
+#include <fsl/estimation/checkpoints.hpp>
+
+BOOST_AUTO_TEST_SUITE(checkpoints)
+
+using namespace Fsl::Estimation;
+
+typedef std::vector<double> Values;
+
+/**
+ * A model with a single state which decays and has a deviation added
+ * each time step
+ */
+struct Model {
+    double state = 0;
+};
+
+/**
+ * Set up checkpoints for time steps 0 to 19 where parameter 0 scales the initial state
+ * and parameter `1+time` is the deviation for each time step
+ */
+void setup(Checkpoints<Model>& checkpoints){
+    checkpoints.initialise = [](Model& model, const Values& values){
+        model.state = 10*values[0];
+    };
+    checkpoints.step = [](Model& model, const Values& values, unsigned int time){
+        model.state = 0.8*model.state + values[1+time];
+        double observed = std::sin(time);
+        return -std::pow(model.state-observed,2);
+    };
+    for(unsigned int time=0;time<=19;time++) checkpoints.depends(1+time,time);
+}
+
+Values values(double scale, double shift, unsigned int from){
+    Values values(21);
+    values[0] = scale;
+    for(unsigned int time=0;time<=19;time++) values[1+time] = 0.1*time + (time>=from?shift:0);
+    return values;
+}
+
+BOOST_AUTO_TEST_CASE(partial_equals_full){
+    for(unsigned int interval : {1u,3u,7u}){
+        Checkpoints<Model> partial(0,19,interval);
+        setup(partial);
+
+        for(unsigned int from : {15u,0u,19u,4u,10u}){
+            partial.likelihood(values(1,0,0));
+            Values changed = values(1,0.5*(from+1),from);
+
+            Checkpoints<Model> full(0,19,interval);
+            setup(full);
+            double expected = full.likelihood(changed);
+            BOOST_CHECK_EQUAL(full.skipped,0u);
+
+            unsigned long simulated = partial.simulated;
+            BOOST_CHECK_EQUAL(partial.likelihood(changed),expected);
+            // Only time steps from the checkpoint at or before `from` are re-simulated
+            BOOST_CHECK_EQUAL(partial.simulated-simulated,20-from/interval*interval);
+        }
+
+        // Changing the initial scale causes a full simulation
+        unsigned long simulated = partial.simulated;
+        Checkpoints<Model> full(0,19,interval);
+        setup(full);
+        BOOST_CHECK_EQUAL(partial.likelihood(values(2,0,0)),full.likelihood(values(2,0,0)));
+        BOOST_CHECK_EQUAL(partial.simulated-simulated,20u);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(concurrent){
+    std::vector<Values> proposals;
+    std::vector<double> expecteds;
+    for(unsigned int index=0;index<200;index++){
+        proposals.push_back(values(1+(index%3),0.01*index,index%20));
+        Checkpoints<Model> full(0,19);
+        setup(full);
+        expecteds.push_back(full.likelihood(proposals.back()));
+    }
+
+    Checkpoints<Model> shared(0,19);
+    setup(shared);
+    std::vector<double> results(proposals.size());
+    Fsl::Parallel::each(proposals.size(),[&](unsigned int index){
+        results[index] = shared.likelihood(proposals[index]);
+    },4);
+    for(unsigned int index=0;index<proposals.size();index++){
+        BOOST_CHECK_EQUAL(results[index],expecteds[index]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
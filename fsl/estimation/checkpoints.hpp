@@ -0,0 +1,244 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+namespace Fsl {
+namespace Estimation {
+
+/**
+ * Checkpointed model simulation for partial re-simulation during estimation
+ *
+ * Usually each likelihood evaluation re-simulates the model from the first time
+ * step, even when a proposal only changes parameters that first act late in the
+ * series (e.g. a recent selectivity block or recruitment deviation).
+ * `Checkpoints` keeps a copy of the model state at the start of time steps
+ * of the last evaluation, along with the data likelihood terms for each time step.
+ * A map from each parameter to the first time step that it affects is used
+ * to restart the simulation of a new proposal from the nearest checkpoint and
+ * to only recompute likelihood terms from that time step on.
+ *
+ * Usage:
+ *
+ *     Checkpoints<MyModel> checkpoints(1950,2013);
+ *     checkpoints.initialise = [&](MyModel& model, const Values& values){
+ *         MyParameters parameters;
+ *         parameters.load(values);
+ *         parameters.initialise(model);
+ *     };
+ *     checkpoints.step = [&](MyModel& model, const Values& values, unsigned int time){
+ *         MyParameters parameters;
+ *         parameters.load(values);
+ *         parameters.set(model,time);
+ *         model.update(time);
+ *         return data.likelihood(model,time);
+ *     };
+ *     // Recruitment deviations only affect the year they are for
+ *     for(unsigned int year=1950;year<=2013;year++) checkpoints.depends(year-1950+offset,year);
+ *     estimator.likelihood = [&](const Values& values){
+ *         return checkpoints.likelihood(values) + priors(values);
+ *     };
+ *
+ * `step` must apply `values` itself, as above, rather than rely on state set by
+ * `initialise`: when restarting from a checkpoint `initialise` is not called, so
+ * anything it set would be from an earlier evaluation. `step` must also be deterministic
+ * given the parameter values (e.g. recruitment deviations are parameters rather than
+ * random draws) otherwise restarting from a checkpoint will not reproduce the full simulation.
+ *
+ * `likelihood()` can be called concurrently (e.g. by `Lbfgsb`, `Sir` or `Tempering`). Only
+ * one thread at a time uses, and updates, the checkpoints; a call made while another
+ * is in progress does a full simulation on a local model instead of waiting. So `initialise`
+ * and `step` must themselves be safe to call concurrently (e.g. not share a parameter set
+ * between calls, as above). For concurrent estimators with many threads it is more efficient to
+ * give each thread its own `Checkpoints` (e.g. a `thread_local` instance within the likelihood function).
+ */
+template<
+    class Model
+>
+class Checkpoints {
+public:
+
+    typedef std::vector<double> Values;
+
+    /**
+     * First and last time steps simulated
+     */
+    unsigned int first;
+    unsigned int last;
+
+    /**
+     * Number of time steps between checkpoints. Larger values use less
+     * memory but, on average, re-simulate more time steps
+     */
+    unsigned int interval = 1;
+
+    /**
+     * First time step affected by each parameter. Parameters without an
+     * entry (or with an entry equal to `first`) are assumed to affect
+     * model initialisation and cause a full simulation when changed.
+     */
+    std::vector<unsigned int> firsts;
+
+    /**
+     * Initialise a model from parameter values (e.g. take it to
+     * unfished equilibrium)
+     */
+    std::function<void (Model& model, const Values& values)> initialise;
+
+    /**
+     * Update a model for a time step and return the data likelihood term for
+     * that time step
+     */
+    std::function<double (Model& model, const Values& values, unsigned int time)> step;
+
+    /**
+     * Counts of the time steps simulated and skipped (because
+     * they were restored from a checkpoint)
+     */
+    std::atomic<unsigned long> simulated;
+    std::atomic<unsigned long> skipped;
+
+    Checkpoints(unsigned int first = 0, unsigned int last = 0, unsigned int interval = 1):
+        first(first),
+        last(last),
+        interval(interval),
+        simulated(0),
+        skipped(0){
+    }
+
+    /**
+     * Declare that a parameter first affects the model at a time step
+     *
+     * @param parameter Index of the parameter
+     * @param time      First time step the parameter affects
+     */
+    Checkpoints& depends(unsigned int parameter, unsigned int time){
+        if(firsts.size()<=parameter) firsts.resize(parameter+1,first);
+        firsts[parameter] = time;
+        return *this;
+    }
+
+    /**
+     * Discard all checkpoints so that the next evaluation is a full simulation
+     */
+    Checkpoints& reset(void){
+        std::lock_guard<std::mutex> lock(mutex_);
+        valid_ = false;
+        return *this;
+    }
+
+    /**
+     * Get the earliest time step affected by changing from the last
+     * evaluated parameter values to `values`
+     */
+    unsigned int earliest(const Values& values) const {
+        if(not valid_ or values.size()!=values_.size()) return first;
+        unsigned int earliest = last+1;
+        for(unsigned int index=0;index<values.size();index++){
+            if(values[index]!=values_[index]){
+                unsigned int time = index<firsts.size()?firsts[index]:first;
+                if(time<earliest) earliest = time;
+                if(earliest<=first) return first;
+            }
+        }
+        return earliest;
+    }
+
+    /**
+     * Calculate the data likelihood for parameter values, restarting from the
+     * nearest checkpoint
+     */
+    double likelihood(const Values& values){
+        if(not initialise or not step) throw std::runtime_error("`Checkpoints::initialise` and `Checkpoints::step` must be defined");
+        if(last<first) throw std::runtime_error("`Checkpoints::last` must not be less than `Checkpoints::first`");
+
+        std::unique_lock<std::mutex> lock(mutex_,std::try_to_lock);
+        if(not lock.owns_lock()) return full_(values);
+
+        if(interval<1) interval = 1;
+        unsigned int steps = last-first+1;
+        unsigned int restart = earliest(values);
+        if(restart>last){
+            // No parameter that affects the simulated period has changed
+            values_ = values;
+            skipped += steps;
+            return total_();
+        }
+
+        // Find the checkpoint at or before the restart time step
+        unsigned int checkpoint = (restart-first)/interval;
+        unsigned int time = first + checkpoint*interval;
+
+        Model model;
+        if(time==first){
+            models_.resize((steps+interval-1)/interval);
+            terms_.resize(steps);
+            // Invalidate before re-initialising so that an exception
+            // does not leave inconsistent checkpoints
+            valid_ = false;
+            initialise(model,values);
+        } else {
+            model = models_[checkpoint];
+            valid_ = false;
+        }
+        skipped += time-first;
+
+        for(;time<=last;time++){
+            unsigned int offset = time-first;
+            if(offset%interval==0) models_[offset/interval] = model;
+            terms_[offset] = step(model,values,time);
+            simulated++;
+        }
+
+        values_ = values;
+        valid_ = true;
+        return total_();
+    }
+
+private:
+
+    /**
+     * Held while checkpoints are used or updated
+     */
+    std::mutex mutex_;
+
+    bool valid_ = false;
+    Values values_;
+
+    /**
+     * Model states at the start of every `interval`th time step
+     */
+    std::vector<Model> models_;
+
+    /**
+     * Data likelihood terms for each time step
+     */
+    std::vector<double> terms_;
+
+    double total_(void) const {
+        double sum = 0;
+        for(auto term : terms_) sum += term;
+        return sum;
+    }
+
+    /**
+     * Full simulation which does not use, or update, checkpoints
+     */
+    double full_(const Values& values){
+        Model model;
+        initialise(model,values);
+        double sum = 0;
+        for(unsigned int time=first;time<=last;time++){
+            sum += step(model,values,time);
+            simulated++;
+        }
+        return sum;
+    }
+};
+
+} // namespace Estimation
+} // namespace Fsl
@@ -2,3 +2,4 @@
 
 #include <fsl/estimation/parameters.hpp>
 #include <fsl/estimation/data.hpp>
+#include <fsl/estimation/checkpoints.hpp>
@@ -57,8 +57,14 @@ private:
 
     double likelihood_(int trial,const Values& candidate,std::ostream& errors_file){
         double like = NAN;
+        std::string error;
         try {            
-            like = likelihood(candidate);
+            like = evaluate_(candidate,errors?&error:nullptr);
+            if(error.length()>0){
+                errors_file<<trial<<"\t"<<error;
+                for(auto par : candidate) errors_file<<"\t"<<par;
+                errors_file<<std::endl;
+            }
         } catch(const std::exception& e){
             errors_file<<trial<<"\t"<<e.what();
             for(auto par : candidate) errors_file<<"\t"<<par;
@@ -140,9 +146,9 @@ public:
 
             // Log
             if(trial%log==0){
-                if(log_file.tellp()==0) log_file<<"trial\trows\tworst\tmean\tbest\tlast\tacceptance"<<std::endl;
+                if(log_file.tellp()==0) log_file<<"trial\trows\tworst\tmean\tbest\tlast\tacceptance\tcache"<<std::endl;
                 double acceptance = log>0?accepted/double(log):NAN;
-                log_file<<trial<<"\t"<<rows<<"\t"<<worst<<"\t"<<mean<<"\t"<<best<<"\t"<<likelihood<<"\t"<<acceptance<<std::endl;
+                log_file<<trial<<"\t"<<rows<<"\t"<<worst<<"\t"<<mean<<"\t"<<best<<"\t"<<likelihood<<"\t"<<acceptance<<"\t"<<cache.rate()<<std::endl;
                 accepted = 0;
             }
             // Store
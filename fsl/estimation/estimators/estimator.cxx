@@ -0,0 +1,54 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/estimation/variables-old.hpp>
+#include <fsl/estimation/estimators/estimator.hpp>
+
+BOOST_AUTO_TEST_SUITE(estimator)
+
+using namespace Fsl::Estimation;
+using namespace Fsl::Estimation::Estimators;
+
+/**
+ * Minimal estimator exposing `evaluate_()`
+ */
+class Evaluator : public Estimator<Evaluator> {
+public:
+    Evaluator(void):
+        Estimator<Evaluator>((boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string()){
+    }
+
+    using Estimator<Evaluator>::evaluate_;
+};
+
+BOOST_AUTO_TEST_CASE(cache){
+    Evaluator evaluator;
+    evaluator.cache.capacity(10);
+    unsigned int calls = 0;
+    evaluator.likelihood_checked([&calls](const Values& values, std::string* error) -> double {
+        calls++;
+        if(values[0]<0){
+            if(error) *error = "negative";
+            return NAN;
+        }
+        return -values[0];
+    });
+
+    // Successful evaluations are cached
+    BOOST_CHECK_EQUAL(evaluator.evaluate_({1}),-1);
+    BOOST_CHECK_EQUAL(evaluator.evaluate_({1}),-1);
+    BOOST_CHECK_EQUAL(calls,1u);
+
+    // Failures are not, so the error is described each time
+    for(unsigned int time=0;time<2;time++){
+        std::string error;
+        BOOST_CHECK(std::isnan(evaluator.evaluate_({-1},&error)));
+        BOOST_CHECK_EQUAL(error,"negative");
+    }
+    BOOST_CHECK_EQUAL(calls,3u);
+    BOOST_CHECK_EQUAL(evaluator.cache.size(),1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <fsl/estimation/cache.hpp>
+#include <fsl/estimation/sink.hpp>
+
 namespace Fsl {
 namespace Estimation {
 namespace Estimators {
@@ -25,6 +28,30 @@ public:
     std::function<Values (void)> initial;
     std::function<Values (const Values&)> restrict;
     std::function<double (const Values&)> likelihood;
+
+    /**
+     * Gradient of `likelihood` with respect to values (optional, used by
+     * gradient-based estimators instead of finite differences)
+     */
+    std::function<Values (const Values&)> gradient;
+
+    /**
+     * Set `likelihood` from a function with an exception-free failure path
+     * (e.g. using `Matiri::initialise(std::string*)`) which returns NaN for invalid values
+     * and, only if `error` is not null, writes a description of why to `error`.
+     *
+     * Invalid parameter values are routine during estimation (e.g. proposals outside
+     * the region where a model is defined) so throwing, and formatting a description,
+     * for each of them is expensive. Model methods taking a `std::string* error` follow this
+     * convention: they return `false` (or NaN) rather than throwing and only format a
+     * description if `error` is not null. Estimators which log errors only ask for
+     * descriptions if `errors` is true, so rejecting invalid values is cheap.
+     */
+    Derived& likelihood_checked(std::function<double (const Values&, std::string* error)> function){
+        checked_ = function;
+        if(function) likelihood = [function](const Values& values){ return function(values,nullptr); };
+        return derived();
+    }
     
     /*
      * @}
@@ -50,6 +77,26 @@ public:
      */
     unsigned int store = 1000;
 
+    /**
+     * Streaming sink for samples. If open (e.g. using `stream()`), chain based estimators push
+     * samples to it rather than appending them to `samples`, so that memory use is constant, and
+     * flush it rather than rewriting the samples file every `store` iterations.
+     */
+    Sink sink;
+
+    /**
+     * Cache of likelihoods keyed by values. Disabled by default, set a capacity
+     * (e.g. `cache.capacity(10000)`) to avoid re-evaluating the likelihood of values
+     * which have already been evaluated (e.g. values restricted to the same bounds
+     * by `restrict`). Only use if `likelihood` is deterministic.
+     *
+     * Estimators evaluate `likelihood` through the cache (see `evaluate_()`), and
+     * those which write a `log.tsv` include its hit rate in a `cache` column. Only the
+     * total likelihood is cached; estimators needing components (e.g. `Profiler::components`)
+     * calculate them separately.
+     */
+    Cache<double> cache;
+
 
     Estimator(const std::string& directory = "estimator"):
         directory(directory){
@@ -77,6 +124,66 @@ public:
         return derived();
     }
 
+    /**
+     * Stream samples to a file (by default `samples.tsv`, or `samples.bin` for binary
+     * encoding, in `directory`). Names of parameters are taken from `samples`.
+     *
+     * @param burnin Number of samples to discard
+     * @param thin   Write every `thin`th sample after burn-in
+     */
+    Derived& stream(unsigned long burnin = 0, unsigned int thin = 1, Sink::Encoding encoding = Sink::tsv, const std::string& path=""){
+        std::string filename;
+        if(path.length()==0) filename = directory+(encoding==Sink::binary?"/samples.bin":"/samples.tsv");
+        else filename = path;
+        std::vector<std::string> names = samples.names();
+        names.push_back("likelihood");
+        sink.encoding = encoding;
+        sink.burnin = burnin;
+        sink.thin = thin;
+        sink.open(filename,names);
+        return derived();
+    }
+
+protected:
+
+    /**
+     * Function set by `likelihood_checked()`
+     */
+    std::function<double (const Values&, std::string*)> checked_;
+
+    /**
+     * Evaluate `likelihood`, using `cache` if it is enabled. Exceptions and
+     * failures (NaN) are not cached so that, if evaluated again, the description
+     * of the error is available.
+     *
+     * @param error If not null, and `likelihood_checked()` was used, a description of
+     *              any error is written to it
+     */
+    double evaluate_(const Values& values, std::string* error = nullptr){
+        double like;
+        if(cache.find(values,like)) return like;
+        like = checked_?checked_(values,error):likelihood(values);
+        if(not std::isnan(like)) cache.insert(values,like);
+        return like;
+    }
+
+    /**
+     * Record a sample from a chain: push to `sink` if it is open, otherwise
+     * append to `samples`
+     */
+    void record_(const Values& values, double likelihood){
+        if(sink.is_open()) sink.push(values,likelihood);
+        else samples.append(values,likelihood);
+    }
+
+    /**
+     * Store samples: flush `sink` if it is open, otherwise write `samples`
+     */
+    void store_(void){
+        if(sink.is_open()) sink.flush();
+        else write();
+    }
+
 };
 
 }
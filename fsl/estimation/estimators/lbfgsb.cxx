@@ -0,0 +1,119 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/estimation/variables-old.hpp>
+#include <fsl/estimation/estimators/lbfgsb.hpp>
+#include <fsl/estimation/estimators/testing.hpp>
+
+BOOST_AUTO_TEST_SUITE(lbfgsb)
+
+using namespace Fsl::Estimation;
+using namespace Fsl::Estimation::Estimators;
+using namespace Fsl::Estimation::Estimators::Testing;
+
+/**
+ * Negative Rosenbrock function (maximum of 0 at (1,1))
+ */
+double rosenbrock(const Values& values){
+    double x = values[0];
+    double y = values[1];
+    return -(std::pow(1-x,2)+100*std::pow(y-x*x,2));
+}
+
+BOOST_AUTO_TEST_CASE(unbounded){
+    Lbfgsb optimiser(temporary());
+    optimiser.initial = [](){ return Values{-1.2,1}; };
+    optimiser.likelihood = rosenbrock;
+    optimiser.threads = 2;
+    optimiser.run();
+
+    BOOST_CHECK_SMALL(optimiser.mode[0]-1,1e-3);
+    BOOST_CHECK_SMALL(optimiser.mode[1]-1,2e-3);
+    BOOST_CHECK_SMALL(optimiser.maximum,1e-6);
+    BOOST_CHECK_EQUAL(optimiser.samples.rows(),1u);
+}
+
+BOOST_AUTO_TEST_CASE(bounded){
+    // Quadratic with unconstrained maximum at (3,-1,0.5) and
+    // bounds which are active for the first two parameters
+    Lbfgsb optimiser(temporary());
+    optimiser.initial = [](){ return Values{0,0,0}; };
+    optimiser.likelihood = [](const Values& values){
+        double a = values[0]-3;
+        double b = values[1]+1;
+        double c = values[2]-0.5;
+        return -(a*a + 2*b*b + 4*c*c + a*c);
+    };
+    optimiser.minimums = {-2,0,-2};
+    optimiser.maximums = {2,2,2};
+    optimiser.run();
+
+    // With x=2 and y=0 at their bounds, c is maximised at 0.5+1/8
+    BOOST_CHECK_EQUAL(optimiser.mode[0],2);
+    BOOST_CHECK_EQUAL(optimiser.mode[1],0);
+    BOOST_CHECK_SMALL(optimiser.mode[2]-0.625,1e-4);
+    BOOST_CHECK_CLOSE(optimiser.maximum,-(1+2-1.0/16),1e-4);
+}
+
+BOOST_AUTO_TEST_CASE(covariance){
+    // For a multivariate normal the covariance is the inverse of the Hessian
+    Lbfgsb optimiser(temporary());
+    optimiser.initial = [](){ return Values{0,0}; };
+    const double rho = 0.5;
+    optimiser.likelihood = [rho](const Values& values){
+        double x = (values[0]-1)/2;
+        double y = values[1]+1;
+        return -0.5*(x*x-2*rho*x*y+y*y)/(1-rho*rho);
+    };
+    optimiser.run();
+
+    BOOST_CHECK_SMALL(optimiser.mode[0]-1,1e-4);
+    BOOST_CHECK_SMALL(optimiser.mode[1]+1,1e-4);
+    BOOST_REQUIRE_EQUAL(optimiser.covariance.size(),2u);
+    BOOST_CHECK_CLOSE(optimiser.covariance[0][0],4,0.1);
+    BOOST_CHECK_CLOSE(optimiser.covariance[1][1],1,0.1);
+    BOOST_CHECK_CLOSE(optimiser.covariance[0][1],2*rho,0.1);
+
+    // Gradient, if supplied, is used instead of finite differences
+    Lbfgsb analytic(temporary());
+    analytic.initial = optimiser.initial;
+    analytic.likelihood = optimiser.likelihood;
+    analytic.gradient = [rho](const Values& values){
+        double x = (values[0]-1)/2;
+        double y = values[1]+1;
+        return Values{-(x-rho*y)/(1-rho*rho)/2,-(y-rho*x)/(1-rho*rho)};
+    };
+    analytic.run();
+    BOOST_CHECK_SMALL(analytic.mode[0]-1,1e-4);
+    BOOST_CHECK_SMALL(analytic.mode[1]+1,1e-4);
+    BOOST_CHECK(analytic.evaluations<optimiser.evaluations);
+}
+
+BOOST_AUTO_TEST_CASE(cache){
+    // Likelihoods are evaluated through the cache so a repeated run
+    // does not call `likelihood` at all
+    Lbfgsb optimiser(temporary());
+    optimiser.initial = [](){ return Values{-1.2,1}; };
+    std::atomic<unsigned int> calls(0);
+    optimiser.likelihood = [&calls](const Values& values){
+        calls++;
+        return rosenbrock(values);
+    };
+    optimiser.cache.capacity(100000);
+    optimiser.log = 1;
+    optimiser.run();
+    unsigned int first = calls;
+    optimiser.run();
+    BOOST_CHECK_EQUAL(calls,first);
+    BOOST_CHECK_CLOSE(optimiser.cache.rate(),0.5,1e-10);
+
+    // Hit rate is logged
+    std::ifstream file(optimiser.directory+"/log.tsv");
+    std::string line;
+    std::getline(file,line);
+    BOOST_CHECK_EQUAL(line,"iteration\tevaluations\tlikelihood\tgradient\tstep\tcache");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,491 @@
+#pragma once
+
+#include <functional>
+#include <fstream>
+
+#include <fsl/parallel.hpp>
+#include <fsl/math/probability/normal.hpp>
+#include <fsl/estimation/estimators/estimator.hpp>
+
+namespace Fsl {
+namespace Estimation {
+namespace Estimators {
+
+/**
+ * Bounded limited-memory BFGS maximum a posteriori optimiser
+ *
+ * Finds the mode of `likelihood` (which should include the priors) within
+ * the bounds `minimums` and `maximums` (usually the prior bounds e.g. from `Set::minimums()`).
+ * Bounds are handled by gradient projection: variables at a bound whose gradient
+ * points out of the feasible region are held fixed and the limited-memory BFGS direction
+ * is computed for the remaining free variables. Steps are projected back onto the bounds
+ * with a backtracking (Armijo) line search along the projected path.
+ *
+ * If `gradient` is defined it is used, otherwise gradients are calculated by central
+ * finite differences (one-sided at bounds) with the 2 x parameters evaluations done
+ * in parallel. So `likelihood` must be safe to call concurrently from several
+ * threads (e.g. each call uses its own model instance).
+ *
+ * After convergence the Hessian at the mode is calculated by finite differences and
+ * inverted to give `covariance`. `proposal()` returns a multivariate normal generator
+ * based on the mode and covariance which can be used as the `initial` function
+ * of the MCMC estimators e.g.
+ *
+ *     Lbfgsb optimiser;
+ *     optimiser.initial = ...; optimiser.likelihood = ...;
+ *     optimiser.minimums = set.minimums(); optimiser.maximums = set.maximums();
+ *     optimiser.run();
+ *     DEMC demc;
+ *     demc.initial = optimiser.proposal();
+ */
+class Lbfgsb : public Estimator<Lbfgsb> {
+public:
+
+    /**
+     * Lower and upper bounds on parameters. If empty, parameters are unbounded.
+     */
+    Values minimums;
+    Values maximums;
+
+    /**
+     * Number of correction pairs retained for the inverse Hessian approximation
+     */
+    unsigned int memory = 10;
+
+    /**
+     * Convergence tolerance on the largest projected gradient component
+     */
+    double tolerance = 1e-5;
+
+    /**
+     * Convergence tolerance on the relative change in likelihood
+     */
+    double relative = 1e-10;
+
+    /**
+     * Relative step size for finite differences (defaults to the cube root
+     * of machine epsilon which is optimal for central differences)
+     */
+    double step = 6e-6;
+
+    /**
+     * Number of threads for finite differences. 0 for number of hardware threads.
+     */
+    unsigned int threads = 0;
+
+    /**
+     * Results: parameter values and likelihood at the mode, its gradient and the
+     * covariance matrix (inverse Hessian of the negative likelihood)
+     */
+    Values mode;
+    double maximum = NAN;
+    Values gradient_mode;
+    std::vector<Values> covariance;
+
+    /**
+     * Number of likelihood evaluations
+     */
+    unsigned long evaluations = 0;
+
+    Lbfgsb(const std::string& directory = "estimator"):
+        Estimator<Lbfgsb>(directory){
+    }
+
+    /**
+     * Find the mode starting from `initial()`
+     *
+     * @param iterations Maximum number of iterations
+     */
+    void run(unsigned int iterations = 1000){
+        std::ofstream log_file;
+        if(log) log_file.open(directory+"/log.tsv");
+        if(log_file.is_open()) log_file<<"iteration\tevaluations\tlikelihood\tgradient\tstep\tcache"<<std::endl;
+
+        Values x = project_(initial());
+        unsigned int size = x.size();
+        double f = objective_(x);
+        if(not std::isfinite(f)) throw std::runtime_error("`Lbfgsb::run` : likelihood is not finite at initial values");
+        Values g = gradient_(x,f);
+
+        std::vector<Values> ss;
+        std::vector<Values> ys;
+
+        for(unsigned int iteration=0;iteration<iterations;iteration++){
+            // Check for convergence using the projected gradient
+            double norm = projected_norm_(x,g);
+            if(norm<tolerance) break;
+
+            // Variables at a bound with gradient pointing outwards are fixed
+            std::vector<bool> free(size);
+            for(unsigned int index=0;index<size;index++) free[index] = not at_bound_(x,g,index);
+
+            // Two-loop recursion for direction on free variables
+            Values d(size,0);
+            for(unsigned int index=0;index<size;index++) d[index] = free[index]?-g[index]:0;
+            unsigned int pairs = ss.size();
+            Values alphas(pairs);
+            for(int pair=pairs-1;pair>=0;pair--){
+                double rho = 1/dot_(ys[pair],ss[pair],free);
+                alphas[pair] = rho*dot_(ss[pair],d,free);
+                for(unsigned int index=0;index<size;index++) if(free[index]) d[index] -= alphas[pair]*ys[pair][index];
+            }
+            if(pairs>0){
+                double gamma = dot_(ss[pairs-1],ys[pairs-1],free)/dot_(ys[pairs-1],ys[pairs-1],free);
+                if(std::isfinite(gamma) and gamma>0) for(auto& value : d) value *= gamma;
+            }
+            for(unsigned int pair=0;pair<pairs;pair++){
+                double rho = 1/dot_(ys[pair],ss[pair],free);
+                double beta = rho*dot_(ys[pair],d,free);
+                for(unsigned int index=0;index<size;index++) if(free[index]) d[index] += ss[pair][index]*(alphas[pair]-beta);
+            }
+
+            // Fall back to steepest descent if not a descent direction
+            double slope = dot_(g,d);
+            if(not std::isfinite(slope) or slope>=0){
+                for(unsigned int index=0;index<size;index++) d[index] = free[index]?-g[index]:0;
+                ss.clear();
+                ys.clear();
+            }
+
+            // Backtracking line search along the projected path
+            double alpha = 1;
+            if(ss.empty()){
+                double length = std::sqrt(dot_(d,d));
+                if(length>0) alpha = std::min(1.0,1/length);
+            }
+            Values x_new;
+            double f_new = INFINITY;
+            bool found = false;
+            for(unsigned int trial=0;trial<40;trial++){
+                x_new = x;
+                for(unsigned int index=0;index<size;index++) x_new[index] += alpha*d[index];
+                x_new = project_(x_new);
+                Values dx(size);
+                for(unsigned int index=0;index<size;index++) dx[index] = x_new[index]-x[index];
+                f_new = objective_(x_new);
+                if(std::isfinite(f_new) and f_new<=f+1e-4*dot_(g,dx)){
+                    found = true;
+                    break;
+                }
+                alpha *= 0.5;
+            }
+            if(not found) break;
+
+            Values g_new = gradient_(x_new,f_new);
+            Values s(size);
+            Values y(size);
+            for(unsigned int index=0;index<size;index++){
+                s[index] = x_new[index]-x[index];
+                y[index] = g_new[index]-g[index];
+            }
+            if(dot_(s,y)>1e-10*dot_(y,y)){
+                ss.push_back(s);
+                ys.push_back(y);
+                if(ss.size()>memory){
+                    ss.erase(ss.begin());
+                    ys.erase(ys.begin());
+                }
+            }
+
+            double change = std::fabs(f-f_new)/std::max(std::max(std::fabs(f),std::fabs(f_new)),1.0);
+            x = x_new;
+            f = f_new;
+            g = g_new;
+
+            if(log_file.is_open() and log>0 and iteration%log==0){
+                log_file<<iteration<<"\t"<<evaluations<<"\t"<<-f<<"\t"<<projected_norm_(x,g)<<"\t"<<alpha<<"\t"<<cache.rate()<<std::endl;
+            }
+            if(change<relative) break;
+        }
+
+        mode = x;
+        maximum = -f;
+        gradient_mode = g;
+        for(auto& value : gradient_mode) value = -value;
+
+        hessian_();
+
+        samples.append(mode,maximum);
+        write();
+        write_covariance();
+    }
+
+    /**
+     * Write the covariance matrix to a tab separated file
+     */
+    Lbfgsb& write_covariance(const std::string& path=""){
+        std::string filename;
+        if(path.length()==0) filename = directory+"/covariance.tsv";
+        else filename = path;
+        std::ofstream file(filename);
+        for(auto& row : covariance){
+            for(unsigned int column=0;column<row.size();column++){
+                if(column>0) file<<"\t";
+                file<<row[column];
+            }
+            file<<std::endl;
+        }
+        return *this;
+    }
+
+    /**
+     * Get a function which generates random parameter values from
+     * a multivariate normal distribution with the mode as mean and the covariance
+     * (multiplied by `scale` squared) as covariance
+     */
+    std::function<Values (void)> proposal(double scale = 1) const {
+        unsigned int size = mode.size();
+        // Cholesky factor of covariance
+        std::vector<Values> lower(size,Values(size,0));
+        if(not cholesky_(covariance,lower)){
+            for(unsigned int index=0;index<size;index++){
+                double variance = covariance.size()>index?covariance[index][index]:0;
+                lower[index][index] = variance>0?std::sqrt(variance):0;
+            }
+        }
+        Values centre = mode;
+        Values mins = minimums;
+        Values maxs = maximums;
+        return [centre,lower,scale,mins,maxs](void){
+            unsigned int size = centre.size();
+            Math::Probability::Normal normal(0,1);
+            Values z(size);
+            for(auto& value : z) value = normal.random();
+            Values values = centre;
+            for(unsigned int row=0;row<size;row++){
+                for(unsigned int column=0;column<=row;column++) values[row] += scale*lower[row][column]*z[column];
+                if(mins.size()==size) values[row] = std::max(values[row],mins[row]);
+                if(maxs.size()==size) values[row] = std::min(values[row],maxs[row]);
+            }
+            return values;
+        };
+    }
+
+private:
+
+    double lower_(unsigned int index) const {
+        return index<minimums.size()?minimums[index]:-INFINITY;
+    }
+
+    double upper_(unsigned int index) const {
+        return index<maximums.size()?maximums[index]:INFINITY;
+    }
+
+    Values project_(Values values) const {
+        for(unsigned int index=0;index<values.size();index++){
+            values[index] = std::min(std::max(values[index],lower_(index)),upper_(index));
+        }
+        return values;
+    }
+
+    bool at_bound_(const Values& x, const Values& g, unsigned int index) const {
+        return (x[index]<=lower_(index) and g[index]>0) or (x[index]>=upper_(index) and g[index]<0);
+    }
+
+    double projected_norm_(const Values& x, const Values& g) const {
+        double norm = 0;
+        for(unsigned int index=0;index<x.size();index++){
+            double projected = std::min(std::max(x[index]-g[index],lower_(index)),upper_(index))-x[index];
+            norm = std::max(norm,std::fabs(projected));
+        }
+        return norm;
+    }
+
+    static double dot_(const Values& a, const Values& b){
+        double sum = 0;
+        for(unsigned int index=0;index<a.size();index++) sum += a[index]*b[index];
+        return sum;
+    }
+
+    static double dot_(const Values& a, const Values& b, const std::vector<bool>& free){
+        double sum = 0;
+        for(unsigned int index=0;index<a.size();index++) if(free[index]) sum += a[index]*b[index];
+        return sum;
+    }
+
+    /**
+     * Negative likelihood (minimised), infinite if the likelihood throws or is not finite
+     */
+    double objective_(const Values& values){
+        evaluations++;
+        double like = NAN;
+        try {
+            like = evaluate_(values);
+        } catch(...){
+        }
+        return std::isfinite(like)?-like:INFINITY;
+    }
+
+    /**
+     * Finite difference step for a parameter
+     */
+    double step_(const Values& x, unsigned int index) const {
+        return step*std::max(std::fabs(x[index]),1.0);
+    }
+
+    /**
+     * Gradient of the objective from `gradient` or by central differences, one-sided
+     * at bounds, with evaluations in parallel
+     */
+    Values gradient_(const Values& x, double f){
+        if(gradient){
+            Values g = gradient(x);
+            for(auto& value : g) value = -value;
+            return g;
+        }
+        unsigned int size = x.size();
+        Values plus(size);
+        Values minus(size);
+        Values hs(size);
+        std::vector<bool> forward(size,false);
+        std::vector<bool> backward(size,false);
+        for(unsigned int index=0;index<size;index++){
+            hs[index] = step_(x,index);
+            if(x[index]+hs[index]>upper_(index)) backward[index] = true;
+            else if(x[index]-hs[index]<lower_(index)) forward[index] = true;
+        }
+        std::atomic<unsigned long> count(0);
+        Parallel::each(2*size,[&](unsigned int task){
+            unsigned int index = task/2;
+            bool up = task%2==0;
+            if((up and backward[index]) or (not up and forward[index])) return;
+            Values point = x;
+            point[index] += up?hs[index]:-hs[index];
+            double like = NAN;
+            try {
+                like = evaluate_(point);
+            } catch(...){
+            }
+            (up?plus:minus)[index] = std::isfinite(like)?-like:INFINITY;
+            count++;
+        },threads);
+        evaluations += count;
+
+        Values g(size);
+        for(unsigned int index=0;index<size;index++){
+            if(backward[index]) g[index] = (f-minus[index])/hs[index];
+            else if(forward[index]) g[index] = (plus[index]-f)/hs[index];
+            else g[index] = (plus[index]-minus[index])/(2*hs[index]);
+            if(not std::isfinite(g[index])) g[index] = 0;
+        }
+        return g;
+    }
+
+    /**
+     * Calculate the Hessian of the objective at the mode by central differences and
+     * invert it to get the covariance. Parameters at a bound are excluded and given zero variance.
+     */
+    void hessian_(void){
+        const Values& x = mode;
+        unsigned int size = x.size();
+        double f = -maximum;
+
+        std::vector<unsigned int> free;
+        for(unsigned int index=0;index<size;index++){
+            double h = step_(x,index)*100;
+            if(x[index]-h>lower_(index) and x[index]+h<upper_(index)) free.push_back(index);
+        }
+        unsigned int n = free.size();
+
+        // Each task is an element of the upper triangle
+        std::vector<std::pair<unsigned int,unsigned int>> elements;
+        for(unsigned int row=0;row<n;row++){
+            for(unsigned int column=row;column<n;column++) elements.push_back({row,column});
+        }
+        std::vector<Values> hessian(n,Values(n,0));
+        std::atomic<unsigned long> count(0);
+        auto eval = [&](const Values& point){
+            double like = NAN;
+            try {
+                like = evaluate_(point);
+            } catch(...){
+            }
+            count++;
+            return std::isfinite(like)?-like:INFINITY;
+        };
+        Parallel::each(elements.size(),[&](unsigned int task){
+            unsigned int row = elements[task].first;
+            unsigned int column = elements[task].second;
+            unsigned int i = free[row];
+            unsigned int j = free[column];
+            // Larger steps than for gradients since second differences are more
+            // susceptible to rounding error
+            double hi = step_(x,i)*100;
+            double hj = step_(x,j)*100;
+            double value;
+            if(i==j){
+                Values up = x;
+                up[i] += hi;
+                Values down = x;
+                down[i] -= hi;
+                value = (eval(up)-2*f+eval(down))/(hi*hi);
+            } else {
+                Values pp = x, pm = x, mp = x, mm = x;
+                pp[i] += hi; pp[j] += hj;
+                pm[i] += hi; pm[j] -= hj;
+                mp[i] -= hi; mp[j] += hj;
+                mm[i] -= hi; mm[j] -= hj;
+                value = (eval(pp)-eval(pm)-eval(mp)+eval(mm))/(4*hi*hj);
+            }
+            hessian[row][column] = value;
+            hessian[column][row] = value;
+        },threads);
+        evaluations += count;
+
+        // Invert using Cholesky decomposition
+        std::vector<Values> lower(n,Values(n,0));
+        std::vector<Values> inverse(n,Values(n,0));
+        if(cholesky_(hessian,lower)){
+            // Solve L L' X = I column by column
+            for(unsigned int column=0;column<n;column++){
+                Values y(n,0);
+                for(unsigned int row=0;row<n;row++){
+                    double sum = row==column?1:0;
+                    for(unsigned int k=0;k<row;k++) sum -= lower[row][k]*y[k];
+                    y[row] = sum/lower[row][row];
+                }
+                for(int row=n-1;row>=0;row--){
+                    double sum = y[row];
+                    for(unsigned int k=row+1;k<n;k++) sum -= lower[k][row]*inverse[k][column];
+                    inverse[row][column] = sum/lower[row][row];
+                }
+            }
+        } else {
+            // Hessian not positive definite so use the inverse of its diagonal
+            for(unsigned int row=0;row<n;row++){
+                inverse[row][row] = hessian[row][row]>0?1/hessian[row][row]:0;
+            }
+        }
+
+        covariance.assign(size,Values(size,0));
+        for(unsigned int row=0;row<n;row++){
+            for(unsigned int column=0;column<n;column++) covariance[free[row]][free[column]] = inverse[row][column];
+        }
+    }
+
+    /**
+     * Cholesky decomposition of a symmetric matrix, returns false if
+     * the matrix is not positive definite
+     */
+    static bool cholesky_(const std::vector<Values>& matrix, std::vector<Values>& lower){
+        unsigned int n = matrix.size();
+        lower.assign(n,Values(n,0));
+        for(unsigned int row=0;row<n;row++){
+            for(unsigned int column=0;column<=row;column++){
+                double sum = matrix[row][column];
+                for(unsigned int k=0;k<column;k++) sum -= lower[row][k]*lower[column][k];
+                if(row==column){
+                    if(not(sum>0)) return false;
+                    lower[row][row] = std::sqrt(sum);
+                } else {
+                    lower[row][column] = sum/lower[column][column];
+                }
+            }
+        }
+        return true;
+    }
+};
+
+}
+}
+}
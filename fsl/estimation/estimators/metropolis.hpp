@@ -7,6 +7,7 @@
 
 #include <fsl/math/probability/uniform.hpp>
 #include <fsl/math/probability/normal.hpp>
+#include <fsl/estimation/sink.hpp>
 
 namespace Fsl {
 namespace Estimation {
@@ -48,6 +49,10 @@ public:
     double acceptance;
     
     Table samples;
+
+    //! Streaming sink for accepted rows. If open, rows are pushed to it
+    //! rather than appended to `samples`
+    Sink sink;
     
     Metropolis(void):
         samples("samples",
@@ -60,6 +65,16 @@ public:
         for(int par=0;par<Parameters;par++) samples.add("p"+boost::lexical_cast<std::string>(par),Real);
     }
     
+    //! Stream accepted rows to a file rather than storing them in `samples`
+    void stream(const std::string& path, unsigned long burnin = 0, unsigned int thin = 1, Sink::Encoding encoding = Sink::tsv){
+        std::vector<std::string> names = {"iteration","acceptance","log_like"};
+        for(int par=0;par<Parameters;par++) names.push_back("p"+boost::lexical_cast<std::string>(par));
+        sink.encoding = encoding;
+        sink.burnin = burnin;
+        sink.thin = thin;
+        sink.open(path,names);
+    }
+    
     void reset(void){
         iterations = 0;
         accepted = 0;
@@ -96,7 +111,8 @@ public:
             row[1] = acceptance;
             row[2] = ll;
             for(int par=0;par<Parameters;par++) row[3+par] = values(par);
-            samples.append(row);
+            if(sink.is_open()) sink.push(row);
+            else samples.append(row);
         }
     }
     
@@ -0,0 +1,83 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/autodiff/reverse.hpp>
+#include <fsl/estimation/variables-old.hpp>
+#include <fsl/estimation/estimators/nuts.hpp>
+#include <fsl/estimation/estimators/testing.hpp>
+
+BOOST_AUTO_TEST_SUITE(nuts)
+
+using namespace Fsl::Estimation;
+using namespace Fsl::Estimation::Estimators;
+using namespace Fsl::Estimation::Estimators::Testing;
+namespace Autodiff = Fsl::Math::Autodiff;
+
+/**
+ * Log density of independent normals with means 1 and -2 and sds 0.5 and 3
+ */
+template<typename Scalar>
+Scalar normal(const std::vector<Scalar>& values){
+    Scalar x = (values[0]-1)/0.5;
+    Scalar y = (values[1]+2)/3;
+    return -0.5*(x*x+y*y);
+}
+
+void check(Nuts& nuts){
+    BOOST_REQUIRE_EQUAL(nuts.samples.rows(),4000u);
+    auto result = moments(nuts.samples);
+    BOOST_CHECK_SMALL(result[0][0]-1,0.05);
+    BOOST_CHECK_SMALL(result[0][1]+2,0.3);
+    BOOST_CHECK_SMALL(result[1][0]-0.5,0.05);
+    BOOST_CHECK_SMALL(result[1][1]-3,0.3);
+    // Adapted metric roughly approximates the posterior variances (it is
+    // estimated from a short warmup window)
+    BOOST_CHECK_CLOSE(nuts.metric[0],0.25,50);
+    BOOST_CHECK_CLOSE(nuts.metric[1],9,50);
+    // Only the odd divergence early in warmup while the step size is being found
+    BOOST_CHECK(nuts.divergences<10);
+}
+
+BOOST_AUTO_TEST_CASE(gradient){
+    Nuts nuts(temporary());
+    nuts.parameters({"x","y"});
+    nuts.initial = [](){ return Values{0,0}; };
+    nuts.likelihood = normal<double>;
+    nuts.gradient = [](const Values& values){
+        Values gradient;
+        Autodiff::gradient(normal<Autodiff::Reverse>,values,gradient);
+        return gradient;
+    };
+    nuts.run(1000,4000);
+    check(nuts);
+}
+
+BOOST_AUTO_TEST_CASE(finite_differences){
+    Nuts nuts(temporary());
+    nuts.parameters({"x","y"});
+    nuts.initial = [](){ return Values{0,0}; };
+    nuts.likelihood = normal<double>;
+    nuts.run(1000,4000);
+    check(nuts);
+}
+
+BOOST_AUTO_TEST_CASE(bounded){
+    // Half-normal: proposals outside the support are divergent
+    // but samples still have the right distribution
+    Nuts nuts(temporary());
+    nuts.parameters({"x"});
+    nuts.initial = [](){ return Values{1}; };
+    nuts.likelihood = [](const Values& values) -> double {
+        if(values[0]<0) return -INFINITY;
+        return -0.5*values[0]*values[0];
+    };
+    nuts.errors = false;
+    nuts.run(1000,4000);
+    auto result = moments(nuts.samples);
+    for(unsigned int row=0;row<nuts.samples.rows();row++) BOOST_REQUIRE(nuts.samples.get(row,0)>=0);
+    BOOST_CHECK_SMALL(result[0][0]-std::sqrt(2/M_PI),0.08);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
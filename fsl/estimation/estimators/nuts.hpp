@@ -0,0 +1,416 @@
+#pragma once
+
+#include <functional>
+#include <fstream>
+
+#include <fsl/parallel.hpp>
+#include <fsl/math/probability/normal.hpp>
+#include <fsl/math/probability/uniform.hpp>
+#include <fsl/estimation/estimators/estimator.hpp>
+
+namespace Fsl {
+namespace Estimation {
+namespace Estimators {
+
+/**
+ * No-U-Turn sampler (NUTS) variant of Hamiltonian Monte Carlo
+ *
+ * Implements the efficient NUTS with dual averaging of the step size
+ * (Hoffman and Gelman 2014, Algorithms 3 and 6) with a diagonal metric
+ * (inverse mass matrix) estimated from the variance of warmup samples.
+ *
+ * `likelihood` should be the log posterior (i.e. include priors) and `gradient`
+ * its gradient (e.g. from `Math::Autodiff::gradient()` applied to a model templated on
+ * `Math::Autodiff::Reverse`). If `gradient` is not defined, central finite differences
+ * are used with evaluations in parallel. Proposals outside the support of the posterior
+ * (i.e. where `likelihood` is not finite or throws) are treated as divergent transitions.
+ *
+ * Samples after warmup are appended to `samples` (or pushed to `sink` if it is open).
+ */
+class Nuts : public Estimator<Nuts> {
+public:
+
+    /**
+     * Target mean acceptance probability for step size adaptation
+     */
+    double delta = 0.8;
+
+    /**
+     * Maximum tree depth (trajectories have at most 2^depth_max leapfrog steps)
+     */
+    unsigned int depth_max = 10;
+
+    /**
+     * Should the diagonal metric be adapted during warmup?
+     */
+    bool adapt_metric = true;
+
+    /**
+     * Number of threads for finite difference gradients
+     */
+    unsigned int threads = 0;
+
+    /**
+     * Step size, diagonal of the inverse mass matrix and
+     * summaries of the last iteration
+     */
+    double step = NAN;
+    Values metric;
+    unsigned int depth = 0;
+    double acceptance = NAN;
+    unsigned long divergences = 0;
+    unsigned long evaluations = 0;
+
+    Nuts(const std::string& directory = "estimator"):
+        Estimator<Nuts>(directory){
+    }
+
+    /**
+     * Run the sampler
+     *
+     * @param warmup     Number of warmup (adaptation) iterations
+     * @param iterations Number of sampling iterations
+     */
+    void run(unsigned int warmup = 1000, unsigned int iterations = 1000){
+        std::ofstream log_file;
+        if(log) log_file.open(directory+"/log.tsv");
+
+        std::ofstream errors_file;
+        if(errors) errors_file.open(directory+"/errors.tsv");
+        errors_ = errors?&errors_file:nullptr;
+
+        Values theta = initial();
+        unsigned int size = theta.size();
+        if(metric.size()!=size) metric.assign(size,1);
+
+        double like = likelihood_(theta);
+        if(not std::isfinite(like)) throw std::runtime_error("`Nuts::run` : likelihood is not finite at initial values");
+        Values grad = gradient_(theta);
+
+        if(not std::isfinite(step) or step<=0) step = reasonable_step_(theta,like,grad);
+
+        // Dual averaging state
+        double mu = std::log(10*step);
+        double bar = 0;
+        double log_step_bar = 0;
+        const double gamma = 0.05;
+        const double t0 = 10;
+        const double kappa = 0.75;
+        unsigned int adaptation = 0;
+
+        // Metric adaptation window: middle of warmup
+        unsigned int window_start = warmup*0.15;
+        unsigned int window_end = warmup*0.9;
+        unsigned int window_count = 0;
+        Values window_mean(size,0);
+        Values window_m2(size,0);
+
+        for(unsigned int iteration=0;iteration<warmup+iterations;iteration++){
+            transition_(theta,like,grad);
+
+            if(iteration<warmup){
+                // Dual averaging of step size
+                adaptation++;
+                double eta = 1.0/(adaptation+t0);
+                bar = (1-eta)*bar + eta*(delta-acceptance);
+                double log_step = mu - std::sqrt(adaptation)/gamma*bar;
+                double weight = std::pow(adaptation,-kappa);
+                log_step_bar = weight*log_step + (1-weight)*log_step_bar;
+                step = std::exp(log_step);
+
+                // Accumulate variance of samples in the window (Welford's algorithm)
+                if(adapt_metric and iteration>=window_start and iteration<window_end){
+                    window_count++;
+                    for(unsigned int index=0;index<size;index++){
+                        double diff = theta[index]-window_mean[index];
+                        window_mean[index] += diff/window_count;
+                        window_m2[index] += diff*(theta[index]-window_mean[index]);
+                    }
+                }
+                if(adapt_metric and iteration+1==window_end and window_count>2){
+                    // Regularise towards unit metric, as in Stan
+                    for(unsigned int index=0;index<size;index++){
+                        double variance = window_m2[index]/(window_count-1);
+                        metric[index] = (window_count/(window_count+5.0))*variance + 1e-3*(5.0/(window_count+5.0));
+                    }
+                    // Restart step size adaptation for new metric
+                    step = reasonable_step_(theta,like,grad);
+                    mu = std::log(10*step);
+                    bar = 0;
+                    log_step_bar = 0;
+                    adaptation = 0;
+                }
+                if(iteration+1==warmup) step = std::exp(log_step_bar);
+            } else {
+                record_(theta,like);
+            }
+
+            // Log
+            if(log_file.is_open() and log>0 and iteration%log==0){
+                if(log_file.tellp()==0) log_file<<"iteration\tlikelihood\tstep\tdepth\tacceptance\tdivergences\tevaluations\tcache"<<std::endl;
+                log_file<<iteration<<"\t"<<like<<"\t"<<step<<"\t"<<depth<<"\t"<<acceptance<<"\t"<<divergences<<"\t"<<evaluations<<"\t"<<cache.rate()<<std::endl;
+            }
+            // Store
+            if(iteration>=warmup and store>0 and (iteration-warmup)%store==0){
+                store_();
+            }
+        }
+        store_();
+        errors_ = nullptr;
+    }
+
+private:
+
+    std::ostream* errors_ = nullptr;
+
+    Math::Probability::Normal normal_ = {0,1};
+    Math::Probability::Uniform uniform_ = {0,1};
+
+    /**
+     * Maximum decrease in joint log probability before a
+     * trajectory is considered divergent
+     */
+    static constexpr double divergence_ = 1000;
+
+    double likelihood_(const Values& theta){
+        evaluations++;
+        double like = NAN;
+        std::string error;
+        try {
+            like = evaluate_(theta,errors_?&error:nullptr);
+            if(errors_ and error.length()>0){
+                *errors_<<"\""<<error<<"\"";
+                for(auto par : theta) *errors_<<"\t"<<par;
+                *errors_<<std::endl;
+            }
+        } catch(const std::exception& e){
+            if(errors_){
+                *errors_<<"\""<<e.what()<<"\"";
+                for(auto par : theta) *errors_<<"\t"<<par;
+                *errors_<<std::endl;
+            }
+        } catch(...){
+            if(errors_){
+                *errors_<<"\"Unknown error\"";
+                for(auto par : theta) *errors_<<"\t"<<par;
+                *errors_<<std::endl;
+            }
+        }
+        return std::isfinite(like)?like:-INFINITY;
+    }
+
+    /**
+     * Gradient of the log posterior, using `gradient` if defined
+     * and otherwise central finite differences
+     */
+    Values gradient_(const Values& theta){
+        if(gradient) return gradient(theta);
+        unsigned int size = theta.size();
+        Values plus(size);
+        Values minus(size);
+        Values hs(size);
+        for(unsigned int index=0;index<size;index++) hs[index] = 6e-6*std::max(std::fabs(theta[index]),1.0);
+        Parallel::each(2*size,[&](unsigned int task){
+            unsigned int index = task/2;
+            Values point = theta;
+            point[index] += task%2==0?hs[index]:-hs[index];
+            double like = NAN;
+            try {
+                like = evaluate_(point);
+            } catch(...){
+            }
+            (task%2==0?plus:minus)[index] = like;
+        },threads);
+        evaluations += 2*size;
+        Values grad(size);
+        for(unsigned int index=0;index<size;index++){
+            grad[index] = (plus[index]-minus[index])/(2*hs[index]);
+            if(not std::isfinite(grad[index])) grad[index] = 0;
+        }
+        return grad;
+    }
+
+    double kinetic_(const Values& r) const {
+        double sum = 0;
+        for(unsigned int index=0;index<r.size();index++) sum += r[index]*r[index]*metric[index];
+        return 0.5*sum;
+    }
+
+    /**
+     * Leapfrog integration step. Returns the log posterior at the new position.
+     */
+    double leapfrog_(Values& theta, Values& r, Values& grad, double epsilon){
+        unsigned int size = theta.size();
+        for(unsigned int index=0;index<size;index++){
+            r[index] += 0.5*epsilon*grad[index];
+            theta[index] += epsilon*metric[index]*r[index];
+        }
+        double like = likelihood_(theta);
+        if(std::isfinite(like)){
+            grad = gradient_(theta);
+            for(unsigned int index=0;index<size;index++) r[index] += 0.5*epsilon*grad[index];
+        }
+        return like;
+    }
+
+    Values momentum_(void){
+        Values r(metric.size());
+        for(unsigned int index=0;index<r.size();index++) r[index] = normal_.random()/std::sqrt(metric[index]);
+        return r;
+    }
+
+    /**
+     * Heuristic for a reasonable initial step size (Hoffman and Gelman 2014, Algorithm 4)
+     */
+    double reasonable_step_(const Values& theta, double like, const Values& grad){
+        double epsilon = 1;
+        Values r = momentum_();
+        double joint = like - kinetic_(r);
+        auto trial = [&](double epsilon){
+            Values theta_new = theta;
+            Values r_new = r;
+            Values grad_new = grad;
+            double like_new = leapfrog_(theta_new,r_new,grad_new,epsilon);
+            double diff = like_new - kinetic_(r_new) - joint;
+            return std::isfinite(diff)?diff:-INFINITY;
+        };
+        double diff = trial(epsilon);
+        double direction = diff>std::log(0.5)?1:-1;
+        for(unsigned int count=0;count<100;count++){
+            if(direction>0 and not(diff>std::log(0.5))) break;
+            if(direction<0 and not(diff<std::log(0.5))) break;
+            epsilon *= std::pow(2.0,direction);
+            diff = trial(epsilon);
+        }
+        return epsilon;
+    }
+
+    struct Tree_ {
+        Values theta_minus, r_minus, grad_minus;
+        Values theta_plus, r_plus, grad_plus;
+        Values theta_proposal, grad_proposal;
+        double like_proposal;
+        double n;
+        bool s;
+        double alpha;
+        double n_alpha;
+        bool divergent;
+    };
+
+    bool no_u_turn_(const Values& theta_minus, const Values& theta_plus, const Values& r_minus, const Values& r_plus) const {
+        double minus = 0;
+        double plus = 0;
+        for(unsigned int index=0;index<theta_minus.size();index++){
+            double diff = theta_plus[index]-theta_minus[index];
+            minus += diff*metric[index]*r_minus[index];
+            plus += diff*metric[index]*r_plus[index];
+        }
+        return minus>=0 and plus>=0;
+    }
+
+    /**
+     * Recursively build a balanced binary tree of leapfrog steps
+     */
+    Tree_ build_(const Values& theta, const Values& r, const Values& grad, double log_u, int direction, unsigned int depth, double epsilon, double joint0){
+        Tree_ tree;
+        if(depth==0){
+            Values theta_new = theta;
+            Values r_new = r;
+            Values grad_new = grad;
+            double like = leapfrog_(theta_new,r_new,grad_new,direction*epsilon);
+            double joint = like - kinetic_(r_new);
+            if(not std::isfinite(joint)) joint = -INFINITY;
+            tree.theta_minus = tree.theta_plus = tree.theta_proposal = theta_new;
+            tree.r_minus = tree.r_plus = r_new;
+            tree.grad_minus = tree.grad_plus = tree.grad_proposal = grad_new;
+            tree.like_proposal = like;
+            tree.n = log_u<=joint?1:0;
+            tree.divergent = not(log_u<divergence_+joint);
+            tree.s = not tree.divergent;
+            tree.alpha = std::min(1.0,std::exp(joint-joint0));
+            if(not std::isfinite(tree.alpha)) tree.alpha = 0;
+            tree.n_alpha = 1;
+            return tree;
+        }
+
+        tree = build_(theta,r,grad,log_u,direction,depth-1,epsilon,joint0);
+        if(tree.s){
+            Tree_ other = direction<0?
+                build_(tree.theta_minus,tree.r_minus,tree.grad_minus,log_u,direction,depth-1,epsilon,joint0):
+                build_(tree.theta_plus,tree.r_plus,tree.grad_plus,log_u,direction,depth-1,epsilon,joint0);
+            if(direction<0){
+                tree.theta_minus = other.theta_minus;
+                tree.r_minus = other.r_minus;
+                tree.grad_minus = other.grad_minus;
+            } else {
+                tree.theta_plus = other.theta_plus;
+                tree.r_plus = other.r_plus;
+                tree.grad_plus = other.grad_plus;
+            }
+            if(tree.n+other.n>0 and uniform_.random()<other.n/(tree.n+other.n)){
+                tree.theta_proposal = other.theta_proposal;
+                tree.grad_proposal = other.grad_proposal;
+                tree.like_proposal = other.like_proposal;
+            }
+            tree.alpha += other.alpha;
+            tree.n_alpha += other.n_alpha;
+            tree.n += other.n;
+            tree.divergent = tree.divergent or other.divergent;
+            tree.s = other.s and no_u_turn_(tree.theta_minus,tree.theta_plus,tree.r_minus,tree.r_plus);
+        }
+        return tree;
+    }
+
+    /**
+     * A single NUTS transition (Hoffman and Gelman 2014, Algorithm 6)
+     */
+    void transition_(Values& theta, double& like, Values& grad){
+        Values r0 = momentum_();
+        double joint0 = like - kinetic_(r0);
+        // Slice variable, on log scale
+        double log_u = joint0 + std::log(uniform_.random());
+
+        Values theta_minus = theta, theta_plus = theta;
+        Values r_minus = r0, r_plus = r0;
+        Values grad_minus = grad, grad_plus = grad;
+        double n = 1;
+        bool s = true;
+        double alpha = 0;
+        double n_alpha = 0;
+        bool divergent = false;
+
+        depth = 0;
+        while(s and depth<depth_max){
+            int direction = uniform_.random()<0.5?-1:1;
+            Tree_ tree = direction<0?
+                build_(theta_minus,r_minus,grad_minus,log_u,direction,depth,step,joint0):
+                build_(theta_plus,r_plus,grad_plus,log_u,direction,depth,step,joint0);
+            if(direction<0){
+                theta_minus = tree.theta_minus;
+                r_minus = tree.r_minus;
+                grad_minus = tree.grad_minus;
+            } else {
+                theta_plus = tree.theta_plus;
+                r_plus = tree.r_plus;
+                grad_plus = tree.grad_plus;
+            }
+            if(tree.s and uniform_.random()<tree.n/n){
+                theta = tree.theta_proposal;
+                grad = tree.grad_proposal;
+                like = tree.like_proposal;
+            }
+            n += tree.n;
+            alpha = tree.alpha;
+            n_alpha = tree.n_alpha;
+            divergent = divergent or tree.divergent;
+            s = tree.s and no_u_turn_(theta_minus,theta_plus,r_minus,r_plus);
+            depth++;
+        }
+        acceptance = n_alpha>0?alpha/n_alpha:0;
+        if(divergent) divergences++;
+    }
+};
+
+}
+}
+}
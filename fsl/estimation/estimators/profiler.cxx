@@ -0,0 +1,105 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/estimation/variables-old.hpp>
+#include <fsl/estimation/estimators/profiler.hpp>
+
+BOOST_AUTO_TEST_SUITE(profiler)
+
+using namespace Fsl::Estimation;
+using namespace Fsl::Estimation::Estimators;
+
+/**
+ * Standard bivariate normal log density (without constant) with correlation `rho`
+ * and a third, independent, parameter. For `x` the slice at `y=0` is
+ * `-0.5*x^2/(1-rho^2)` and the profile (`y=rho*x`) is `-0.5*x^2`.
+ */
+const double rho = 0.8;
+
+double bivariate(const Values& values){
+    double x = values[0];
+    double y = values[1];
+    double z = values[2];
+    return -0.5*(x*x-2*rho*x*y+y*y)/(1-rho*rho) - 0.5*(z-1)*(z-1);
+}
+
+Profiler profiler(bool optimise){
+    Profiler profiler((boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string());
+    profiler.parameters({"x","y","z"});
+    profiler.initial = [](){ return Values{0,0,1}; };
+    profiler.likelihood = bivariate;
+    profiler.minimums = {-2,-2,-5};
+    profiler.maximums = {2,2,5};
+    profiler.points = 9;
+    profiler.optimise = optimise;
+    profiler.threads = 3;
+    return profiler;
+}
+
+BOOST_AUTO_TEST_CASE(slice){
+    Profiler slice = profiler(false);
+    slice.run(std::vector<std::string>{"x","y"});
+    BOOST_REQUIRE_EQUAL(slice.results.size(),18u);
+    for(unsigned int point=0;point<9;point++){
+        auto& result = slice.results[point];
+        BOOST_CHECK_EQUAL(result.parameter,0u);
+        BOOST_CHECK_CLOSE(result.value,-2+0.5*point,1e-10);
+        BOOST_CHECK_SMALL(result.likelihood+0.5*result.value*result.value/(1-rho*rho),1e-10);
+        // Other parameters held at initial values
+        BOOST_CHECK_EQUAL(result.values[1],0);
+        BOOST_CHECK_EQUAL(slice.results[9+point].parameter,1u);
+    }
+    BOOST_CHECK(boost::filesystem::exists(slice.directory+"/profile.tsv"));
+}
+
+BOOST_AUTO_TEST_CASE(components){
+    Profiler profile = profiler(true);
+    // Components of the likelihood: the bivariate part and the independent part
+    profile.components = [](const Values& values){
+        double z = values[2];
+        double independent = -0.5*(z-1)*(z-1);
+        return Values{bivariate(values)-independent,independent};
+    };
+    profile.component_names = {"xy","z"};
+    profile.run(std::vector<std::string>{"x"});
+    BOOST_REQUIRE_EQUAL(profile.results.size(),9u);
+    for(auto& result : profile.results){
+        BOOST_REQUIRE_EQUAL(result.components.size(),2u);
+        BOOST_CHECK_CLOSE(result.components[0]+result.components[1],result.likelihood,1e-10);
+        BOOST_CHECK_SMALL(result.components[0]+0.5*result.value*result.value,1e-6);
+    }
+
+    // One column for each component
+    std::ifstream file(profile.directory+"/profile.tsv");
+    std::string line;
+    std::getline(file,line);
+    BOOST_CHECK_EQUAL(line,"parameter\tvalue\tlikelihood\tx\ty\tz\txy\tz");
+    unsigned int rows = 0;
+    while(std::getline(file,line)){
+        BOOST_CHECK_EQUAL(std::count(line.begin(),line.end(),'\t'),7);
+        rows++;
+    }
+    BOOST_CHECK_EQUAL(rows,9u);
+}
+
+BOOST_AUTO_TEST_CASE(profile){
+    Profiler profile = profiler(true);
+    profile.run(std::vector<unsigned int>{0,2});
+    BOOST_REQUIRE_EQUAL(profile.results.size(),18u);
+    for(unsigned int point=0;point<9;point++){
+        auto& result = profile.results[point];
+        double x = result.value;
+        BOOST_CHECK_SMALL(result.likelihood+0.5*x*x,1e-6);
+        BOOST_CHECK_SMALL(result.values[1]-rho*x,1e-3);
+        BOOST_CHECK_SMALL(result.values[2]-1,1e-3);
+
+        // Profile for z is the same as its slice since it is independent
+        auto& independent = profile.results[9+point];
+        double z = independent.value;
+        BOOST_CHECK_SMALL(independent.likelihood+0.5*(z-1)*(z-1),1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <fstream>
+
+#include <fsl/parallel.hpp>
+#include <fsl/estimation/estimators/estimator.hpp>
+
+namespace Fsl {
+namespace Estimation {
+namespace Estimators {
+
+/**
+ * Likelihood profiles for several parameters, calculated concurrently
+ *
+ * Each profiled parameter is stepped through `points` values between its bounds in
+ * `minimums` and `maximums` (e.g. from `Set::minimums()`). At each point the likelihood is
+ * calculated either with all other parameters held at their values from `initial()` (a "slice")
+ * or, if `optimise` is true, with all other parameters re-optimised within their bounds
+ * (a "profile") using a bounded compass search (see `optimise_()`).
+ *
+ * Points are evaluated on `threads` threads so `likelihood` must be safe to call concurrently.
+ * For slices, all points of all parameters are independent. For profiles, the grid for each
+ * parameter is swept outwards, up and down, from the point nearest its initial value, each
+ * optimisation being warm started from the optimum at the neighbouring point, so the two
+ * sweeps of each parameter are run concurrently.
+ *
+ * Results are in `results` and written to `profile.tsv` in `directory` with columns `parameter`,
+ * `value`, `likelihood`, the values of all parameters at that point and, if `components` is set,
+ * the likelihood components at that point (e.g. for each data set or penalty) so that conflicts
+ * between data sources can be seen.
+ *
+ *     Profiler profiler;
+ *     profiler.initial = [&](){ return mode; };
+ *     profiler.likelihood = ...;
+ *     profiler.minimums = set.minimums(); profiler.maximums = set.maximums();
+ *     profiler.parameters(set.names());
+ *     profiler.optimise = true;
+ *     profiler.run({"r0","steepness"});
+ */
+class Profiler : public Estimator<Profiler> {
+public:
+
+    /**
+     * Lower and upper bounds on parameters. Profiled parameters must have finite bounds.
+     */
+    Values minimums;
+    Values maximums;
+
+    /**
+     * Number of points for each profiled parameter
+     */
+    unsigned int points = 30;
+
+    /**
+     * Re-optimise other parameters at each point?
+     */
+    bool optimise = false;
+
+    /**
+     * Maximum number of likelihood evaluations for each optimisation
+     */
+    unsigned int evaluations = 1000;
+
+    /**
+     * Number of threads. 0 for number of hardware threads.
+     */
+    unsigned int threads = 0;
+
+    /**
+     * Likelihood components at a point. Optional and, like `likelihood`, must be safe to call concurrently.
+     * It is only called once for each point (at the optimum when profiling).
+     */
+    std::function<Values (const Values&)> components;
+
+    /**
+     * Names of likelihood components, used as column names in `profile.tsv`
+     */
+    std::vector<std::string> component_names;
+
+    /**
+     * A point on a profile
+     */
+    struct Point {
+        unsigned int parameter;
+        double value;
+        double likelihood;
+        Values values;
+        Values components;
+    };
+
+    /**
+     * Points for each profiled parameter, in ascending order of value
+     */
+    std::vector<Point> results;
+
+    Profiler(const std::string& directory = "estimator"):
+        Estimator<Profiler>(directory){
+    }
+
+    /**
+     * Profile parameters by name (from `samples.names()` e.g. set using `parameters()`)
+     */
+    void run(const std::vector<std::string>& names){
+        std::vector<std::string> all = samples.names();
+        std::vector<unsigned int> indices;
+        for(auto& name : names){
+            auto iter = std::find(all.begin(),all.end(),name);
+            if(iter==all.end()) throw std::runtime_error("`Profiler::run` : no parameter named <"+name+">");
+            indices.push_back(iter-all.begin());
+        }
+        run(indices);
+    }
+
+    /**
+     * Profile parameters by index
+     */
+    void run(const std::vector<unsigned int>& indices){
+        if(points<2) points = 2;
+        Values start = initial();
+        unsigned int size = start.size();
+        if(minimums.size()!=size or maximums.size()!=size) throw std::runtime_error("`Profiler::run` : `minimums` and `maximums` must have a bound for each parameter");
+
+        // Grid for each parameter and the grid point nearest to its initial value
+        std::vector<Values> grids;
+        std::vector<unsigned int> starts;
+        for(unsigned int index : indices){
+            if(index>=size) throw std::runtime_error("`Profiler::run` : parameter index out of range");
+            double min = minimums[index];
+            double max = maximums[index];
+            if(not std::isfinite(min) or not std::isfinite(max)) throw std::runtime_error("`Profiler::run` : profiled parameters must have finite bounds");
+            Values grid(points);
+            for(unsigned int point=0;point<points;point++) grid[point] = min + (max-min)*point/(points-1);
+            unsigned int nearest = 0;
+            for(unsigned int point=1;point<points;point++){
+                if(std::fabs(grid[point]-start[index])<std::fabs(grid[nearest]-start[index])) nearest = point;
+            }
+            grids.push_back(grid);
+            starts.push_back(nearest);
+        }
+
+        results.assign(indices.size()*points,Point());
+        if(not optimise){
+            Parallel::each(indices.size()*points,[&](unsigned int task){
+                unsigned int which = task/points;
+                unsigned int point = task%points;
+                Values values = start;
+                values[indices[which]] = grids[which][point];
+                results[task] = {indices[which],grids[which][point],objective_(values),values,components_(values)};
+            },threads);
+        } else {
+            Parallel::each(indices.size()*2,[&](unsigned int task){
+                unsigned int which = task/2;
+                bool up = task%2;
+                unsigned int index = indices[which];
+                Values values = start;
+                int step = up?1:-1;
+                for(int point = up?starts[which]:int(starts[which])-1;point>=0 and point<int(points);point+=step){
+                    // Warm start from the optimum at the previous point
+                    values[index] = grids[which][point];
+                    double like = optimise_(values,index);
+                    results[which*points+point] = {index,grids[which][point],like,values,components_(values)};
+                }
+            },threads);
+        }
+
+        write_profile();
+    }
+
+    /**
+     * Write `results` to a tab separated file
+     */
+    Profiler& write_profile(const std::string& path=""){
+        std::string filename;
+        if(path.length()==0) filename = directory+"/profile.tsv";
+        else filename = path;
+        std::vector<std::string> names = samples.names();
+        // Number of component columns (a point where `components` threw may have fewer)
+        std::size_t count = component_names.size();
+        for(auto& result : results) count = std::max(count,result.components.size());
+        std::ofstream file(filename);
+        file<<"parameter\tvalue\tlikelihood";
+        if(results.size()>0){
+            for(unsigned int index=0;index<results[0].values.size();index++){
+                file<<"\t"<<(index<names.size()?names[index]:"p"+std::to_string(index));
+            }
+        }
+        for(unsigned int index=0;index<count;index++){
+            file<<"\t"<<(index<component_names.size()?component_names[index]:"c"+std::to_string(index));
+        }
+        file<<std::endl;
+        for(auto& result : results){
+            file<<(result.parameter<names.size()?names[result.parameter]:"p"+std::to_string(result.parameter));
+            file<<"\t"<<result.value<<"\t"<<result.likelihood;
+            for(auto value : result.values) file<<"\t"<<value;
+            for(unsigned int index=0;index<count;index++) file<<"\t"<<(index<result.components.size()?result.components[index]:NAN);
+            file<<std::endl;
+        }
+        return *this;
+    }
+
+private:
+
+    /**
+     * Likelihood, `-INFINITY` if it throws or is not finite
+     */
+    double objective_(const Values& values){
+        double like = NAN;
+        try {
+            like = evaluate_(values);
+        } catch(...){
+        }
+        return std::isfinite(like)?like:-INFINITY;
+    }
+
+    /**
+     * Likelihood components, empty if `components` is not set or throws
+     * (written as NaNs by `write_profile()`)
+     */
+    Values components_(const Values& values){
+        if(not components) return Values();
+        try {
+            return components(values);
+        } catch(...){
+            return Values();
+        }
+    }
+
+    /**
+     * Maximise the likelihood over all parameters except one using a
+     * bounded compass (pattern) search
+     *
+     * Each iteration tries a step up and down in each free parameter, accepting
+     * improvements, and halves the step sizes when no improvement is found.
+     * This is derivative free so it is robust to the discontinuities often found
+     * in fisheries models.
+     *
+     * @param  values Starting values, updated to the optimum found
+     * @param  fixed  Index of the parameter to hold fixed
+     * @return        Likelihood at the optimum
+     */
+    double optimise_(Values& values, unsigned int fixed){
+        double best = objective_(values);
+        unsigned int size = values.size();
+        Values steps(size,0);
+        Values tolerances(size,0);
+        for(unsigned int index=0;index<size;index++){
+            if(index==fixed or not (minimums[index]<maximums[index])) continue;
+            double range = maximums[index]-minimums[index];
+            if(not std::isfinite(range)) range = std::max(std::fabs(values[index]),1.0);
+            steps[index] = 0.1*range;
+            tolerances[index] = 1e-6*range;
+        }
+
+        unsigned int count = 1;
+        while(count<evaluations){
+            bool improved = false;
+            bool searching = false;
+            for(unsigned int index=0;index<size and count<evaluations;index++){
+                if(steps[index]<=tolerances[index]) continue;
+                searching = true;
+                for(double direction : {1.0,-1.0}){
+                    double current = values[index];
+                    double trial = std::min(std::max(current+direction*steps[index],minimums[index]),maximums[index]);
+                    if(trial==current) continue;
+                    values[index] = trial;
+                    double like = objective_(values);
+                    count++;
+                    if(like>best){
+                        best = like;
+                        improved = true;
+                        break;
+                    }
+                    values[index] = current;
+                }
+            }
+            if(not searching) break;
+            if(not improved){
+                for(auto& step : steps) step *= 0.5;
+            }
+        }
+        return best;
+    }
+};
+
+}
+}
+}
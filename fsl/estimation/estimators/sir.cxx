@@ -0,0 +1,109 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/probability/normal.hpp>
+#include <fsl/estimation/variables-old.hpp>
+#include <fsl/estimation/estimators/sir.hpp>
+#include <fsl/estimation/estimators/testing.hpp>
+
+BOOST_AUTO_TEST_SUITE(sir)
+
+using namespace Fsl::Estimation;
+using namespace Fsl::Estimation::Estimators;
+using namespace Fsl::Estimation::Estimators::Testing;
+using Fsl::Math::Probability::Normal;
+
+BOOST_AUTO_TEST_CASE(normal){
+    // Normal(0,3) prior and normal likelihood with mean 1 and sd 0.5
+    // give a normal posterior
+    double precision = 1/9.0 + 1/0.25;
+    double mean = (1/0.25)/precision;
+    double sd = std::sqrt(1/precision);
+
+    Sir sir(temporary());
+    sir.parameters({"x"});
+    Normal prior(0,3);
+    sir.initial = [&](){ return Values{prior.random()}; };
+    sir.likelihood = [](const Values& values){
+        double z = (values[0]-1)/0.5;
+        return -0.5*z*z;
+    };
+    sir.block = 5000;
+    sir.run(2000,200000);
+
+    BOOST_REQUIRE_EQUAL(sir.samples.rows(),2000u);
+    BOOST_CHECK_EQUAL(sir.draws,200000u);
+    BOOST_CHECK_EQUAL(sir.failures,0u);
+    auto result = moments(sir.samples);
+    BOOST_CHECK_SMALL(result[0][0]-mean,0.05);
+    BOOST_CHECK_SMALL(result[1][0]-sd,0.05);
+    // Effective sample size is draws*E[w]^2/E[w^2] (about 43800)
+    BOOST_CHECK(sir.ess()>40000 and sir.ess()<48000);
+}
+
+BOOST_AUTO_TEST_CASE(failures){
+    Sir sir(temporary());
+    sir.parameters({"x"});
+    Normal prior(0,1);
+    sir.initial = [&](){ return Values{prior.random()}; };
+    // Likelihood fails for negative values so the posterior is the
+    // prior truncated at zero
+    sir.likelihood = [](const Values& values){
+        if(values[0]<0) throw std::runtime_error("negative");
+        return 0.0;
+    };
+    sir.errors = false;
+    sir.run(2000,100000);
+
+    BOOST_CHECK(sir.failures>45000 and sir.failures<55000);
+    for(unsigned int row=0;row<sir.samples.rows();row++) BOOST_REQUIRE(sir.samples.get(row,0)>=0);
+    // Mean of half-normal
+    BOOST_CHECK_SMALL(moments(sir.samples)[0][0]-std::sqrt(2/M_PI),0.05);
+}
+
+BOOST_AUTO_TEST_CASE(errors){
+    // Descriptions from a checked likelihood are written to errors.tsv, and only
+    // asked for if `errors` is true
+    for(bool errors : {true,false}){
+        Sir sir(temporary());
+        sir.parameters({"x"});
+        Normal prior(0,1);
+        sir.initial = [&](){ return Values{prior.random()}; };
+        std::atomic<unsigned int> described(0);
+        sir.likelihood_checked([&described](const Values& values, std::string* error) -> double {
+            if(values[0]<0){
+                if(error){
+                    *error = "negative";
+                    described++;
+                }
+                return NAN;
+            }
+            return 0.0;
+        });
+        sir.errors = errors;
+        sir.run(100,10000);
+
+        BOOST_CHECK(sir.failures>4000 and sir.failures<6000);
+        BOOST_CHECK_EQUAL(described,errors?sir.failures:0);
+        if(errors){
+            std::ifstream file(sir.directory+"/errors.tsv");
+            std::string line;
+            unsigned long lines = 0;
+            while(std::getline(file,line)){
+                std::istringstream fields(line);
+                unsigned long draw;
+                std::string error;
+                double x;
+                fields>>draw>>error>>x;
+                BOOST_CHECK_EQUAL(error,"negative");
+                BOOST_CHECK(x<0);
+                lines++;
+            }
+            BOOST_CHECK_EQUAL(lines,sir.failures);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <fstream>
+#include <mutex>
+
+#include <boost/random/binomial_distribution.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <fsl/parallel.hpp>
+#include <fsl/math/probability/distribution.hpp>
+#include <fsl/estimation/estimators/estimator.hpp>
+
+namespace Fsl {
+namespace Estimation {
+namespace Estimators {
+
+/**
+ * Sampling-importance-resampling (SIR) estimator
+ *
+ * Draws samples from the prior using `initial()` (e.g. `Set::sample()`), weights them
+ * by their likelihood and resamples (with replacement, in proportion to weight) `size`
+ * samples into `samples`. So `likelihood` should be the likelihood of the data only
+ * (i.e. exclude priors).
+ *
+ * Draws are processed in blocks: `initial()` is called for each draw in a block on the
+ * calling thread, then likelihoods of the block are evaluated in parallel (so `likelihood`
+ * must be safe to call concurrently). Rather than keeping every draw, each of the `size` resampled
+ * slots is a weighted reservoir of size one: a new draw replaces the contents of each slot with
+ * probability equal to its weight divided by the total weight so far. This gives exactly
+ * the same distribution as multinomial resampling from all draws, but memory is bounded
+ * by `size` plus one block. All weights are handled on the log scale.
+ *
+ * The effective sample size (ESS) of the importance weights is tracked during the run
+ * and logged every `log` blocks.
+ */
+class Sir : public Estimator<Sir> {
+public:
+
+    /**
+     * Number of draws evaluated in parallel in each block
+     */
+    unsigned int block = 10000;
+
+    /**
+     * Number of threads for likelihood evaluations. 0 for number of hardware threads.
+     */
+    unsigned int threads = 0;
+
+    /**
+     * Number of draws and errors (likelihood not finite or threw an exception)
+     */
+    unsigned long draws = 0;
+    unsigned long failures = 0;
+
+    /**
+     * Log of the sum of weights and of the sum of squared weights
+     */
+    double log_sum = -INFINITY;
+    double log_sum_squares = -INFINITY;
+
+    /**
+     * Largest log weight
+     */
+    double log_max = -INFINITY;
+
+    Sir(const std::string& directory = "estimator"):
+        Estimator<Sir>(directory){
+    }
+
+    /**
+     * Effective sample size of importance weights
+     */
+    double ess(void) const {
+        if(not std::isfinite(log_sum)) return 0;
+        return std::exp(2*log_sum-log_sum_squares);
+    }
+
+    /**
+     * Run the estimator
+     *
+     * @param size  Number of samples to resample
+     * @param total Number of draws from the prior
+     */
+    void run(unsigned int size = 1000, unsigned long total = 1000000){
+        std::ofstream log_file;
+        if(log) log_file.open(directory+"/log.tsv");
+
+        std::ofstream errors_file;
+        if(errors) errors_file.open(directory+"/errors.tsv");
+        std::mutex errors_mutex;
+
+        std::vector<Values> reservoir(size);
+        Values likelihoods(size,NAN);
+        // Slots chosen for replacement by the current draw, marked
+        // by slot and listed so that marks can be cleared
+        std::vector<bool> chosen(size,false);
+        std::vector<unsigned int> picks;
+        draws = 0;
+        failures = 0;
+        log_sum = -INFINITY;
+        log_sum_squares = -INFINITY;
+        log_max = -INFINITY;
+
+        unsigned long blocks = 0;
+        while(draws<total){
+            unsigned int count = std::min<unsigned long>(block,total-draws);
+
+            // Draw from prior on this thread
+            std::vector<Values> candidates(count);
+            for(auto& candidate : candidates) candidate = initial();
+
+            // Evaluate likelihoods concurrently
+            Values logs(count);
+            Parallel::each(count,[&](unsigned int index){
+                double like = NAN;
+                std::string error;
+                try {
+                    like = evaluate_(candidates[index],errors?&error:nullptr);
+                    if(error.length()>0){
+                        std::lock_guard<std::mutex> lock(errors_mutex);
+                        errors_file<<draws+index<<"\t"<<error;
+                        for(auto par : candidates[index]) errors_file<<"\t"<<par;
+                        errors_file<<std::endl;
+                    }
+                } catch(const std::exception& exc){
+                    if(errors){
+                        std::lock_guard<std::mutex> lock(errors_mutex);
+                        errors_file<<draws+index<<"\t"<<exc.what();
+                        for(auto par : candidates[index]) errors_file<<"\t"<<par;
+                        errors_file<<std::endl;
+                    }
+                } catch(...){
+                    if(errors){
+                        std::lock_guard<std::mutex> lock(errors_mutex);
+                        errors_file<<draws+index<<"\t"<<"\"Unknown error\"";
+                        for(auto par : candidates[index]) errors_file<<"\t"<<par;
+                        errors_file<<std::endl;
+                    }
+                }
+                logs[index] = like;
+            },threads);
+
+            // Update reservoirs in draw order
+            for(unsigned int index=0;index<count;index++){
+                double log_weight = logs[index];
+                draws++;
+                if(std::isnan(log_weight) or log_weight==INFINITY){
+                    failures++;
+                    continue;
+                }
+                if(log_weight==-INFINITY) continue;
+
+                log_sum = log_add_(log_sum,log_weight);
+                log_sum_squares = log_add_(log_sum_squares,2*log_weight);
+                log_max = std::max(log_max,log_weight);
+
+                // Probability that each slot is replaced by this draw
+                double probability = std::exp(log_weight-log_sum);
+                unsigned int replace;
+                if(probability>=1) replace = size;
+                else {
+                    boost::random::binomial_distribution<int,double> binomial(size,probability);
+                    replace = binomial(Math::Probability::Generator);
+                }
+                if(replace==0) continue;
+                if(replace==size){
+                    for(unsigned int slot=0;slot<size;slot++){
+                        reservoir[slot] = candidates[index];
+                        likelihoods[slot] = log_weight;
+                    }
+                } else {
+                    // Choose `replace` distinct slots at random (Floyd's algorithm)
+                    picks.clear();
+                    for(unsigned int slot=size-replace;slot<size;slot++){
+                        boost::random::uniform_int_distribution<unsigned int> uniform(0,slot);
+                        unsigned int pick = uniform(Math::Probability::Generator);
+                        if(chosen[pick]) pick = slot;
+                        chosen[pick] = true;
+                        picks.push_back(pick);
+                        reservoir[pick] = candidates[index];
+                        likelihoods[pick] = log_weight;
+                    }
+                    for(unsigned int pick : picks) chosen[pick] = false;
+                }
+            }
+            blocks++;
+
+            // Log
+            if(log_file.is_open() and log>0 and (blocks-1)%log==0){
+                if(log_file.tellp()==0) log_file<<"draws\tfailures\tess\tmax_weight\tdistinct\tcache"<<std::endl;
+                log_file<<draws<<"\t"<<failures<<"\t"<<ess()<<"\t"<<std::exp(log_max-log_sum)<<"\t"<<distinct_(likelihoods,reservoir)<<"\t"<<cache.rate()<<std::endl;
+            }
+        }
+
+        // Store resampled values, replacing any existing samples
+        std::vector<std::string> names = samples.names();
+        samples = Samples();
+        samples.names(names);
+        for(unsigned int slot=0;slot<size;slot++){
+            if(reservoir[slot].size()>0) samples.append(reservoir[slot],likelihoods[slot]);
+        }
+        write();
+    }
+
+private:
+
+    /**
+     * Add two values on the log scale
+     */
+    static double log_add_(double a, double b){
+        if(a==-INFINITY) return b;
+        if(b==-INFINITY) return a;
+        if(a<b) std::swap(a,b);
+        return a + std::log1p(std::exp(b-a));
+    }
+
+    /**
+     * Number of distinct draws in the reservoir
+     */
+    static unsigned int distinct_(const Values& likelihoods, const std::vector<Values>& reservoir){
+        std::vector<std::pair<double,const Values*>> items;
+        for(unsigned int slot=0;slot<reservoir.size();slot++){
+            if(reservoir[slot].size()>0) items.push_back({likelihoods[slot],&reservoir[slot]});
+        }
+        std::sort(items.begin(),items.end(),[](const std::pair<double,const Values*>& a,const std::pair<double,const Values*>& b){
+            if(a.first!=b.first) return a.first<b.first;
+            return *a.second<*b.second;
+        });
+        unsigned int count = 0;
+        for(unsigned int item=0;item<items.size();item++){
+            if(item==0 or items[item].first!=items[item-1].first or *items[item].second!=*items[item-1].second) count++;
+        }
+        return count;
+    }
+};
+
+}
+}
+}
@@ -0,0 +1,66 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/probability/uniform.hpp>
+#include <fsl/estimation/variables-old.hpp>
+#include <fsl/estimation/estimators/tempering.hpp>
+#include <fsl/estimation/estimators/testing.hpp>
+
+BOOST_AUTO_TEST_SUITE(tempering)
+
+using namespace Fsl::Estimation;
+using namespace Fsl::Estimation::Estimators;
+using namespace Fsl::Estimation::Estimators::Testing;
+using Fsl::Math::Probability::Uniform;
+
+BOOST_AUTO_TEST_CASE(normal){
+    Tempering tempering(temporary());
+    tempering.parameters({"x","y"});
+    Uniform uniform(-5,5);
+    tempering.initial = [&](){ return Values{uniform.random(),uniform.random()}; };
+    // Independent normals with means 1 and -2 and sds 0.5 and 2
+    tempering.likelihood = [](const Values& values){
+        double x = (values[0]-1)/0.5;
+        double y = (values[1]+2)/2;
+        return -0.5*(x*x+y*y);
+    };
+    tempering.replicas = 4;
+    tempering.sweeps = 5;
+    tempering.run(1000,20000);
+
+    BOOST_REQUIRE_EQUAL(tempering.samples.rows(),20000u);
+    auto result = moments(tempering.samples);
+    BOOST_CHECK_SMALL(result[0][0]-1,0.05);
+    BOOST_CHECK_SMALL(result[0][1]+2,0.2);
+    BOOST_CHECK_SMALL(result[1][0]-0.5,0.05);
+    BOOST_CHECK_SMALL(result[1][1]-2,0.2);
+
+    // Ladder starts at the posterior and gets hotter
+    BOOST_CHECK_EQUAL(tempering.betas[0],1);
+    for(unsigned int replica=1;replica<4;replica++) BOOST_CHECK(tempering.betas[replica]<tempering.betas[replica-1]);
+    for(auto rate : tempering.swap_rates) BOOST_CHECK(rate>0);
+}
+
+BOOST_AUTO_TEST_CASE(bimodal){
+    // Equal mixture of normals at -4 and 4 with sd 0.5 which a single random walk
+    // chain would not move between
+    Tempering tempering(temporary());
+    tempering.parameters({"x"});
+    tempering.initial = [](){ return Values{-4}; };
+    tempering.likelihood = [](const Values& values){
+        double a = (values[0]+4)/0.5;
+        double b = (values[0]-4)/0.5;
+        return std::log(std::exp(-0.5*a*a)+std::exp(-0.5*b*b));
+    };
+    tempering.replicas = 6;
+    tempering.spacing = 3;
+    tempering.run(2000,20000);
+
+    auto result = moments(tempering.samples);
+    BOOST_CHECK_SMALL(result[0][0],0.6);
+    BOOST_CHECK_SMALL(result[1][0]-std::sqrt(16+0.25),0.3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
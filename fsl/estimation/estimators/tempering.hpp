@@ -0,0 +1,271 @@
+#pragma once
+
+#include <functional>
+#include <fstream>
+
+#include <boost/random/mersenne_twister.hpp>
+
+#include <fsl/parallel.hpp>
+#include <fsl/math/probability/distribution.hpp>
+#include <fsl/estimation/estimators/estimator.hpp>
+
+namespace Fsl {
+namespace Estimation {
+namespace Estimators {
+
+/**
+ * Parallel tempering (replica exchange) estimator for multimodal posteriors
+ *
+ * A ladder of replicas samples the posterior raised to powers (inverse temperatures) `betas`,
+ * from 1 (the posterior) down to a small value for which the posterior is
+ * nearly flat so that the replica moves freely between modes. Each round, replicas are updated
+ * concurrently with `sweeps` adaptive random walk Metropolis steps, on a pool of threads which
+ * persists for the whole run, and then states are swapped between adjacent temperatures.
+ * During warmup the spacing of the ladder is adapted towards equal swap rates between
+ * all adjacent pairs (Vousden, Farr and Mandel 2016).
+ *
+ * `likelihood` should be the log posterior (i.e. include priors) and must be safe to call
+ * concurrently from several threads. `initial()` is only called from the calling thread
+ * and is used for starting values and to scale proposals. Samples from the `beta==1` replica
+ * after warmup are appended to `samples` (or pushed to `sink` if it is open).
+ */
+class Tempering : public Estimator<Tempering> {
+public:
+
+    /**
+     * Number of replicas (and threads)
+     */
+    unsigned int replicas = 8;
+
+    /**
+     * Ratio between adjacent temperatures of the initial ladder
+     */
+    double spacing = 1.7;
+
+    /**
+     * Number of Metropolis steps by each replica between swaps
+     */
+    unsigned int sweeps = 10;
+
+    /**
+     * Target acceptance rate for Metropolis steps
+     */
+    double target = 0.234;
+
+    /**
+     * Inverse temperatures of replicas. If empty, a geometric ladder is created
+     * using `replicas` and `spacing`
+     */
+    Values betas;
+
+    /**
+     * Proportion of swaps accepted between each adjacent pair over the
+     * last `log` rounds
+     */
+    Values swap_rates;
+
+    /**
+     * Proportion of Metropolis steps accepted by each replica over the
+     * last `log` rounds
+     */
+    Values acceptances;
+
+    Tempering(const std::string& directory = "estimator"):
+        Estimator<Tempering>(directory){
+    }
+
+    /**
+     * Run the estimator
+     *
+     * @param warmup Number of rounds (sweeps plus swaps) for adaptation of proposals and ladder
+     * @param rounds Number of sampling rounds
+     */
+    void run(unsigned int warmup = 1000, unsigned int rounds = 10000){
+        std::ofstream log_file;
+        if(log) log_file.open(directory+"/log.tsv");
+
+        if(betas.size()==0){
+            for(unsigned int replica=0;replica<replicas;replica++) betas.push_back(std::pow(spacing,-double(replica)));
+        }
+        replicas = betas.size();
+
+        // Starting values and proposal scale from calls to `initial()`
+        std::vector<Replica_> chains(replicas);
+        Values mean;
+        Values m2;
+        unsigned int count = 0;
+        for(auto& chain : chains){
+            Values values = initial();
+            if(mean.size()==0){
+                mean.assign(values.size(),0);
+                m2.assign(values.size(),0);
+            }
+            count++;
+            for(unsigned int index=0;index<values.size();index++){
+                double diff = values[index]-mean[index];
+                mean[index] += diff/count;
+                m2[index] += diff*(values[index]-mean[index]);
+            }
+            chain.values = values;
+            chain.likelihood = likelihood_(values);
+            // Seed each replica's generator from the main thread's generator
+            chain.generator.seed(Math::Probability::Generator());
+        }
+        Values scales(mean.size(),1);
+        if(count>1){
+            for(unsigned int index=0;index<scales.size();index++){
+                double sd = std::sqrt(m2[index]/(count-1));
+                if(sd>0 and std::isfinite(sd)) scales[index] = sd;
+            }
+        }
+        for(unsigned int replica=0;replica<replicas;replica++){
+            // Hotter replicas take larger steps
+            chains[replica].scale = 2.38/std::sqrt(scales.size())/std::sqrt(betas[replica]);
+        }
+
+        // Log of differences in temperature between adjacent replicas
+        Values log_spacings(replicas>1?replicas-1:0);
+        for(unsigned int pair=0;pair+1<replicas;pair++) log_spacings[pair] = std::log(1/betas[pair+1]-1/betas[pair]);
+
+        unsigned int pairs = replicas>1?replicas-1:0;
+        Values swaps(pairs,0);
+        Values swap_trials(pairs,0);
+        Values accepts(replicas,0);
+        double steps = 0;
+        auto rates = [&](void){
+            swap_rates.resize(pairs);
+            for(unsigned int pair=0;pair<pairs;pair++) swap_rates[pair] = swap_trials[pair]>0?swaps[pair]/swap_trials[pair]:NAN;
+            acceptances.resize(replicas);
+            for(unsigned int replica=0;replica<replicas;replica++) acceptances[replica] = steps>0?accepts[replica]/steps:NAN;
+        };
+
+        // Threads are started once, rather than every round, so that
+        // for cheap likelihoods start-up costs do not dominate
+        Parallel::Pool pool(replicas);
+        for(unsigned int round=0;round<warmup+rounds;round++){
+            bool adapting = round<warmup;
+
+            // Update replicas concurrently, one thread per temperature
+            pool.each(replicas,[&](unsigned int replica){
+                sweep_(chains[replica],betas[replica],scales,adapting,round);
+            });
+            for(unsigned int replica=0;replica<replicas;replica++){
+                accepts[replica] += chains[replica].accepted;
+            }
+            steps += sweeps;
+
+            // Swap between adjacent pairs, alternating between even and odd pairs
+            Values accepted(pairs,0);
+            for(unsigned int pair=round%2;pair+1<replicas;pair+=2){
+                Replica_& colder = chains[pair];
+                Replica_& hotter = chains[pair+1];
+                double ratio = (betas[pair]-betas[pair+1])*(hotter.likelihood-colder.likelihood);
+                if(std::isfinite(ratio) and std::log(uniform_(chains[0].generator))<ratio){
+                    std::swap(colder.values,hotter.values);
+                    std::swap(colder.likelihood,hotter.likelihood);
+                    accepted[pair] = 1;
+                }
+                swap_trials[pair]++;
+                swaps[pair] += accepted[pair];
+            }
+
+            // Adapt ladder so that swap rates equalise. The coldest temperature
+            // is fixed at 1 and the hottest is free to move.
+            if(adapting and replicas>2){
+                double kappa = 1.0/100*(100.0/(round+100));
+                for(unsigned int pair=0;pair+2<replicas;pair++){
+                    log_spacings[pair] += kappa*(accepted[pair]-accepted[pair+1]);
+                }
+                double temperature = 1;
+                for(unsigned int pair=0;pair+1<replicas;pair++){
+                    temperature += std::exp(log_spacings[pair]);
+                    betas[pair+1] = 1/temperature;
+                }
+            }
+
+            if(not adapting) record_(chains[0].values,chains[0].likelihood);
+
+            // Log
+            if(log>0 and round%log==0){
+                rates();
+                if(log_file.is_open()){
+                    if(log_file.tellp()==0){
+                        log_file<<"round\tlikelihood";
+                        for(unsigned int replica=0;replica<replicas;replica++) log_file<<"\tbeta"<<replica;
+                        for(unsigned int replica=0;replica<replicas;replica++) log_file<<"\tacceptance"<<replica;
+                        for(unsigned int pair=0;pair<pairs;pair++) log_file<<"\tswap"<<pair;
+                        log_file<<"\tcache"<<std::endl;
+                    }
+                    log_file<<round<<"\t"<<chains[0].likelihood;
+                    for(auto beta : betas) log_file<<"\t"<<beta;
+                    for(auto rate : acceptances) log_file<<"\t"<<rate;
+                    for(auto rate : swap_rates) log_file<<"\t"<<rate;
+                    log_file<<"\t"<<cache.rate()<<std::endl;
+                }
+                swaps.assign(pairs,0);
+                swap_trials.assign(pairs,0);
+                accepts.assign(replicas,0);
+                steps = 0;
+            }
+            // Store
+            if(not adapting and store>0 and (round-warmup)%store==0){
+                store_();
+            }
+        }
+        if(steps>0) rates();
+        store_();
+    }
+
+private:
+
+    struct Replica_ {
+        Values values;
+        double likelihood = -INFINITY;
+        double scale = 1;
+        unsigned int accepted = 0;
+        boost::mt19937 generator;
+    };
+
+    static double uniform_(boost::mt19937& generator){
+        return Math::Probability::Samplers::uniform(generator);
+    }
+
+    double likelihood_(const Values& values){
+        double like = NAN;
+        try {
+            like = evaluate_(values);
+        } catch(...){
+        }
+        return std::isfinite(like)?like:-INFINITY;
+    }
+
+    /**
+     * Metropolis steps for a replica with adaptation of
+     * the proposal scale towards the target acceptance rate
+     */
+    void sweep_(Replica_& chain, double beta, const Values& scales, bool adapting, unsigned int round){
+        chain.accepted = 0;
+        for(unsigned int step=0;step<sweeps;step++){
+            Values candidate = chain.values;
+            for(unsigned int index=0;index<candidate.size();index++){
+                candidate[index] += chain.scale*scales[index]*Math::Probability::Samplers::normal(chain.generator);
+            }
+            if(restrict) candidate = restrict(candidate);
+            double like = likelihood_(candidate);
+            bool accept = std::isfinite(like) and std::log(uniform_(chain.generator))<beta*(like-chain.likelihood);
+            if(accept){
+                chain.values = candidate;
+                chain.likelihood = like;
+                chain.accepted++;
+            }
+            if(adapting){
+                double rate = 1.0/std::sqrt(round*sweeps+step+1);
+                chain.scale *= std::exp(rate*((accept?1:0)-target));
+            }
+        }
+    }
+};
+
+}
+}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <boost/filesystem.hpp>
+
+#include <fsl/estimation/variables-old.hpp>
+
+namespace Fsl {
+namespace Estimation {
+namespace Estimators {
+
+/**
+ * Helpers shared by the tests of estimators
+ */
+namespace Testing {
+
+/**
+ * A unique path in the temporary directory (e.g. for an estimator's `directory`)
+ */
+inline std::string temporary(void){
+    return (boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string();
+}
+
+/**
+ * Means and standard deviations of the columns of samples
+ *
+ * @returns The means and the standard deviations
+ */
+inline std::vector<Values> moments(const Samples& samples){
+    Values means(samples.columns(),0);
+    Values sds(samples.columns(),0);
+    for(unsigned int column=0;column<samples.columns();column++){
+        double sum = 0;
+        double sum_squares = 0;
+        for(unsigned int row=0;row<samples.rows();row++){
+            double value = samples.get(row,column);
+            sum += value;
+            sum_squares += value*value;
+        }
+        means[column] = sum/samples.rows();
+        sds[column] = std::sqrt(sum_squares/samples.rows()-means[column]*means[column]);
+    }
+    return {means,sds};
+}
+
+}
+}
+}
+}
@@ -2,8 +2,8 @@
 
 #if 0
 #include <boost/algorithm/string.hpp>
-#include <boost/regex.hpp>
 
+#include <fsl/estimation/parse.hpp>
 #include <fsl/estimation/variables.hpp>
 #include <fsl/math/probability/uniform.hpp>
 
@@ -167,57 +167,29 @@ public:
     }
 
     /**
-     * Read a file of tab separated values
+     * Read a file of whitespace separated values
      * 
      * @param  filename Filename to read
      * @param  header   Does the file have a header
-     * @return          [description]
+     * @param  threads  Number of threads used for parsing (see `Parse::table()`)
+     * @return          This set of samples
      */
-    ParameterSamples& read(const std::string& filename,bool header=true){
-        std::ifstream file(filename);
-        std::string line;
-
-        boost::regex rgx("\\s+");
-        boost::sregex_token_iterator end;
-                
-        if(header){
-            std::getline(file, line);
-            boost::sregex_token_iterator iter(line.begin(),line.end(),rgx,-1);
-            for( ; iter != end; ++iter) ids_.push_back(*iter);
+    ParameterSamples& read(const std::string& filename,bool header=true,unsigned int threads=0){
+        Parse::Table table = Parse::table(filename,header,threads);
+        ids_.insert(ids_.end(),table.names.begin(),table.names.end());
+        reserve(size()+table.rows);
+        for(std::size_t row=0;row<table.rows;row++){
+            const double* values = table.row(row);
+            push_back(ParameterSample(std::vector<double>(values,values+table.columns)));
         }
-
-        while(true){
-            std::getline(file, line);
-            if(not file.good()) break;
-            boost::sregex_token_iterator iter(line.begin(),line.end(),rgx,-1);
-            ParameterSample sample;
-            for( ; iter != end; ++iter) sample.push_back(boost::lexical_cast<float>(*iter));
-            push_back(sample);
-        }
-
         return *this;
     }
 
-    void read_ss3(const std::string& filename){
-        // Read in posterior
-        std::ifstream file(filename);
-        std::string line;
-
-        // Get header
-        std::getline(file, line);
-        boost::regex rgx("\\s+");
-        boost::sregex_token_iterator iter(line.begin(),line.end(),rgx,-1);
-        boost::sregex_token_iterator end;
-        for( ; iter != end; ++iter) ids_.push_back(*iter);
-
-        while(true){
-            std::getline(file, line);
-            if(not file.good()) break;
-            boost::sregex_token_iterator iter(line.begin(),line.end(),rgx,-1);
-            ParameterSample sample;
-            for( ; iter != end; ++iter) sample.push_back(boost::lexical_cast<float>(*iter));
-            push_back(sample);
-        }
+    /**
+     * Read a Stock Synthesis posteriors file (e.g. `posteriors.sso`)
+     */
+    void read_ss3(const std::string& filename,unsigned int threads=0){
+        read(filename,true,threads);
     }
 
     void write(const std::string& filename){
@@ -0,0 +1,158 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#include <boost/filesystem.hpp>
+
+#include <fsl/estimation/parse.hpp>
+
+BOOST_AUTO_TEST_SUITE(parse)
+
+using namespace Fsl::Estimation;
+
+/**
+ * Parse a string as a single field
+ */
+double number(const std::string& field){
+    return Parse::number(field.c_str(),field.c_str()+field.length());
+}
+
+/**
+ * Parse a string as a table
+ */
+Parse::Table table(const std::string& text, bool header, unsigned int threads){
+    return Parse::table(text.c_str(),text.c_str()+text.length(),header,threads);
+}
+
+BOOST_AUTO_TEST_CASE(numbers){
+    BOOST_CHECK_EQUAL(number("0"),0);
+    BOOST_CHECK_EQUAL(number("42"),42);
+    BOOST_CHECK_EQUAL(number("-1.5"),-1.5);
+    BOOST_CHECK_EQUAL(number("+2.25"),2.25);
+    BOOST_CHECK_EQUAL(number(".5"),0.5);
+    BOOST_CHECK_EQUAL(number("3."),3);
+    BOOST_CHECK_EQUAL(number("1e3"),1000);
+    BOOST_CHECK_EQUAL(number("1.25E-2"),0.0125);
+    BOOST_CHECK_EQUAL(number("-0.000123"),-0.000123);
+    // Outside the fast path
+    BOOST_CHECK_EQUAL(number("1e300"),1e300);
+    BOOST_CHECK_EQUAL(number("123456789012345678901234"),123456789012345678901234.0);
+    BOOST_CHECK(std::isinf(number("inf")));
+
+    BOOST_CHECK_THROW(number("abc"),std::runtime_error);
+    BOOST_CHECK_THROW(number("1.5x"),std::runtime_error);
+    BOOST_CHECK_THROW(number("1e"),std::runtime_error);
+    BOOST_CHECK_THROW(number("-"),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(na){
+    BOOST_CHECK(std::isnan(number("NA")));
+    BOOST_CHECK_THROW(number("NAB"),std::runtime_error);
+
+    Parse::Table result = table("a b\n1 NA\nNA 2\n",true,1);
+    BOOST_REQUIRE_EQUAL(result.rows,2u);
+    BOOST_CHECK_EQUAL(result(0,0),1);
+    BOOST_CHECK(std::isnan(result(0,1)));
+    BOOST_CHECK(std::isnan(result(1,0)));
+    BOOST_CHECK_EQUAL(result(1,1),2);
+}
+
+BOOST_AUTO_TEST_CASE(precision){
+    // Values written with various numbers of significant digits (as by
+    // FSL, R and Stock Synthesis) are converted exactly as by `strtod`
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> mantissa(-10,10);
+    std::uniform_int_distribution<int> exponent(-30,30);
+    char field[64];
+    unsigned int count = 0;
+    for(int trial=0;trial<100000;trial++){
+        double value = mantissa(generator)*std::pow(10.0,exponent(generator));
+        for(int digits : {6,10,15,17,19,21}){
+            for(const char* format : {"%.*g","%.*e"}){
+                std::snprintf(field,sizeof(field),format,digits,value);
+                double expected = std::strtod(field,nullptr);
+                double parsed = Parse::number(field,field+std::strlen(field));
+                if(std::memcmp(&parsed,&expected,sizeof(double))!=0){
+                    BOOST_ERROR("<"<<field<<"> converted to "<<parsed<<" but strtod gives "<<expected);
+                    return;
+                }
+                count++;
+            }
+        }
+    }
+    BOOST_CHECK_EQUAL(count,1200000u);
+
+    // Full precision values round trip
+    for(double value : {0.1,1.0/3,M_PI,-2.2250738585072014e-308,1.7976931348623157e308,123456.789e-10}){
+        std::snprintf(field,sizeof(field),"%.17g",value);
+        BOOST_CHECK_EQUAL(Parse::number(field,field+std::strlen(field)),value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(chunks){
+    // Enough rows, with blank lines and uneven spacing, that each
+    // chunk boundary falls part way through a line
+    std::string text = "x\ty\tz\n";
+    for(int row=0;row<1000;row++){
+        text += std::to_string(row)+"  "+std::to_string(row*0.5)+"\t"+(row%7==0?"NA":std::to_string(-row))+"\r\n";
+        if(row%100==0) text += "\n";
+    }
+
+    Parse::Table serial = table(text,true,1);
+    BOOST_REQUIRE_EQUAL(serial.rows,1000u);
+    BOOST_REQUIRE_EQUAL(serial.columns,3u);
+    BOOST_CHECK_EQUAL(serial.names[2],"z");
+    BOOST_CHECK_EQUAL(serial(999,1),499.5);
+
+    for(bool header : {true,false}){
+        // Without a header the number of columns is determined from the first line
+        std::string body = header?text:text.substr(text.find('\n')+1);
+        for(unsigned int threads : {2u,3u,7u,64u}){
+            Parse::Table parallel = table(body,header,threads);
+            BOOST_REQUIRE_EQUAL(parallel.rows,serial.rows);
+            BOOST_REQUIRE_EQUAL(parallel.columns,serial.columns);
+            for(std::size_t index=0;index<serial.values.size();index++){
+                double a = serial.values[index];
+                double b = parallel.values[index];
+                if(not (a==b or (std::isnan(a) and std::isnan(b)))){
+                    BOOST_ERROR("value "<<index<<" with "<<threads<<" threads differs");
+                    break;
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(row_length){
+    // Too few values in the last row
+    BOOST_CHECK_THROW(table("a b\n1 2\n3\n",true,1),std::runtime_error);
+    // Too many values compared to the header
+    BOOST_CHECK_THROW(table("a b\n1 2 3\n",true,1),std::runtime_error);
+    // Compared to the first row when there is no header
+    BOOST_CHECK_THROW(table("1 2\n3 4 5\n",false,1),std::runtime_error);
+
+    // In a chunk other than the first
+    std::string text;
+    for(int row=0;row<100;row++) text += "1 2 3\n";
+    text += "1 2\n";
+    BOOST_CHECK_THROW(table(text,false,4),std::runtime_error);
+
+    // Errors from files include the file name
+    std::string filename = (boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string();
+    std::ofstream(filename)<<"a b\n1 2\n3\n";
+    try {
+        Parse::table(filename);
+        BOOST_ERROR("no exception thrown");
+    } catch(const std::runtime_error& error){
+        BOOST_CHECK(std::string(error.what()).find(filename)!=std::string::npos);
+        BOOST_CHECK(std::string(error.what()).find("Row has 1 values but expected 2")!=std::string::npos);
+    }
+    boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
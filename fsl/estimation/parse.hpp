@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fsl/parallel.hpp>
+
+namespace Fsl {
+namespace Estimation {
+namespace Parse {
+
+/**
+ * A table of numbers parsed from a file of whitespace separated values
+ * (e.g. samples written by estimators or Stock Synthesis `posteriors.sso` files)
+ */
+struct Table {
+    std::vector<std::string> names;
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+
+    /**
+     * Values in row-major order
+     */
+    std::vector<double> values;
+
+    double operator()(std::size_t row, std::size_t column) const {
+        return values[row*columns+column];
+    }
+
+    const double* row(std::size_t row) const {
+        return values.data()+row*columns;
+    }
+};
+
+inline bool space(char c){
+    return c==' ' or c=='\t' or c=='\r';
+}
+
+/**
+ * Convert a field to a double
+ *
+ * `NA` is converted to `NAN`. Most numbers written by FSL, R or Stock Synthesis
+ * (up to 19 significant digits and exponents that keep the value exactly
+ * representable) are converted on a fast path which gives the correctly rounded result.
+ * All other fields fall back to `std::strtod` which requires that the field is followed
+ * by a non-numeric character (e.g. whitespace or the terminating null of a `Buffer`).
+ *
+ * @param begin Start of field
+ * @param end   End of field
+ */
+inline double number(const char* begin, const char* end){
+    static const double powers[] = {
+        1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,
+        1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22
+    };
+
+    const char* cursor = begin;
+    if(end-begin==2 and begin[0]=='N' and begin[1]=='A') return NAN;
+
+    bool negative = false;
+    if(cursor<end and (*cursor=='-' or *cursor=='+')){
+        negative = *cursor=='-';
+        cursor++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    while(cursor<end and *cursor>='0' and *cursor<='9'){
+        if(digits<19){
+            mantissa = mantissa*10 + (*cursor-'0');
+            if(mantissa>0) digits++;
+        } else exponent++;
+        any = true;
+        cursor++;
+    }
+    if(cursor<end and *cursor=='.'){
+        cursor++;
+        while(cursor<end and *cursor>='0' and *cursor<='9'){
+            if(digits<19){
+                mantissa = mantissa*10 + (*cursor-'0');
+                if(mantissa>0) digits++;
+                exponent--;
+            }
+            any = true;
+            cursor++;
+        }
+    }
+    bool fast = any and digits<19;
+    if(fast and cursor<end and (*cursor=='e' or *cursor=='E')){
+        cursor++;
+        bool negative_exponent = false;
+        if(cursor<end and (*cursor=='-' or *cursor=='+')){
+            negative_exponent = *cursor=='-';
+            cursor++;
+        }
+        int value = 0;
+        bool exponent_digits = false;
+        while(cursor<end and *cursor>='0' and *cursor<='9'){
+            if(value<10000) value = value*10 + (*cursor-'0');
+            exponent_digits = true;
+            cursor++;
+        }
+        if(not exponent_digits) fast = false;
+        exponent += negative_exponent?-value:value;
+    }
+    if(fast and cursor==end and mantissa<=(uint64_t(1)<<53) and exponent>=-22 and exponent<=22){
+        double value = static_cast<double>(mantissa);
+        if(exponent<0) value /= powers[-exponent];
+        else value *= powers[exponent];
+        return negative?-value:value;
+    }
+
+    char* stop;
+    double value = std::strtod(begin,&stop);
+    if(stop!=end or begin==end) throw std::runtime_error("Unable to convert <"+std::string(begin,end)+"> to a number");
+    return value;
+}
+
+/**
+ * Contents of a file in a null-terminated buffer
+ */
+class Buffer : public std::vector<char> {
+public:
+
+    Buffer(const std::string& filename){
+        std::FILE* file = std::fopen(filename.c_str(),"rb");
+        if(not file) throw std::runtime_error("Unable to open file <"+filename+">");
+        std::fseek(file,0,SEEK_END);
+        long size = std::ftell(file);
+        std::fseek(file,0,SEEK_SET);
+        resize(size+1);
+        std::size_t read = size>0?std::fread(data(),1,size,file):0;
+        std::fclose(file);
+        if(read!=static_cast<std::size_t>(size)) throw std::runtime_error("Unable to read file <"+filename+">");
+        (*this)[size] = 0;
+    }
+
+    const char* begin(void) const {
+        return data();
+    }
+
+    const char* end(void) const {
+        return data()+size()-1;
+    }
+};
+
+/**
+ * Parse the lines in `[begin,end)` appending the values of each field to `values`
+ *
+ * @return Number of rows parsed
+ */
+inline std::size_t lines(const char* begin, const char* end, std::size_t& columns, std::vector<double>& values){
+    std::size_t rows = 0;
+    const char* cursor = begin;
+    while(cursor<end){
+        std::size_t fields = 0;
+        while(cursor<end and *cursor!='\n'){
+            while(cursor<end and space(*cursor)) cursor++;
+            if(cursor==end or *cursor=='\n') break;
+            const char* field = cursor;
+            while(cursor<end and *cursor!='\n' and not space(*cursor)) cursor++;
+            values.push_back(number(field,cursor));
+            fields++;
+        }
+        if(cursor<end) cursor++;
+        if(fields==0) continue;
+        if(columns==0) columns = fields;
+        else if(fields!=columns){
+            throw std::runtime_error(
+                "Row has "+std::to_string(fields)+" values but expected "+std::to_string(columns)
+            );
+        }
+        rows++;
+    }
+    return rows;
+}
+
+/**
+ * Parse a buffer of whitespace separated values
+ *
+ * The buffer is split at line boundaries into chunks which are
+ * converted in parallel.
+ *
+ * @param begin   Start of buffer
+ * @param end     End of buffer (must point to a null or whitespace character)
+ * @param header  Does the first line contain column names?
+ * @param threads Number of threads. 0 to use one thread for every 4MB, up to the number of hardware threads
+ */
+inline Table table(const char* begin, const char* end, bool header = true, unsigned int threads = 0){
+    Table table;
+
+    const char* cursor = begin;
+    if(header){
+        while(cursor<end and *cursor!='\n'){
+            while(cursor<end and space(*cursor)) cursor++;
+            if(cursor==end or *cursor=='\n') break;
+            const char* field = cursor;
+            while(cursor<end and *cursor!='\n' and not space(*cursor)) cursor++;
+            table.names.push_back(std::string(field,cursor));
+        }
+        if(cursor<end) cursor++;
+        table.columns = table.names.size();
+    }
+
+    std::size_t size = end-cursor;
+    if(threads==0){
+        threads = size/(4<<20)+1;
+        unsigned int hardware = Parallel::threads();
+        if(threads>hardware) threads = hardware;
+    }
+
+    // Split into chunks that start at the beginning of a line
+    std::vector<const char*> bounds = {cursor};
+    for(unsigned int chunk=1;chunk<threads;chunk++){
+        const char* bound = cursor + size*chunk/threads;
+        if(bound<bounds.back()) bound = bounds.back();
+        while(bound<end and *bound!='\n') bound++;
+        if(bound<end) bound++;
+        bounds.push_back(bound);
+    }
+    bounds.push_back(end);
+
+    unsigned int chunks = bounds.size()-1;
+    if(table.columns==0 and chunks>1){
+        // Determine number of columns from the first line so that
+        // chunks can be checked independently
+        std::vector<double> first;
+        const char* line_end = cursor;
+        while(line_end<end and *line_end!='\n') line_end++;
+        lines(cursor,line_end,table.columns,first);
+    }
+
+    std::vector<std::vector<double>> values(chunks);
+    std::vector<std::size_t> rows(chunks);
+    std::vector<std::size_t> columns(chunks,table.columns);
+    Parallel::each(chunks,[&](unsigned int chunk){
+        rows[chunk] = lines(bounds[chunk],bounds[chunk+1],columns[chunk],values[chunk]);
+    },threads);
+
+    if(chunks==1){
+        table.columns = columns[0];
+        table.values.swap(values[0]);
+    } else {
+        std::size_t total = 0;
+        for(auto& chunk : values) total += chunk.size();
+        table.values.reserve(total);
+        for(auto& chunk : values) table.values.insert(table.values.end(),chunk.begin(),chunk.end());
+    }
+    for(auto count : rows) table.rows += count;
+
+    return table;
+}
+
+/**
+ * Parse a file of whitespace separated values
+ *
+ * @param filename Name of file
+ * @param header   Does the first line contain column names?
+ * @param threads  Number of threads (see above)
+ */
+inline Table table(const std::string& filename, bool header = true, unsigned int threads = 0){
+    Buffer buffer(filename);
+    try {
+        return table(buffer.begin(),buffer.end(),header,threads);
+    } catch(const std::exception& exc){
+        throw std::runtime_error("Error parsing file <"+filename+"> : "+exc.what());
+    }
+}
+
+} // namespace Parse
+} // namespace Estimation
+} // namespace Fsl
@@ -0,0 +1,112 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/estimation/variables-old.hpp>
+#include <fsl/estimation/predictive.hpp>
+
+BOOST_AUTO_TEST_SUITE(predictive)
+
+using namespace Fsl::Estimation;
+
+/**
+ * Samples of a single variable with a large offset relative to its spread
+ * so that naive sum of squares would lose precision
+ */
+Samples example(unsigned int rows){
+    Samples samples;
+    samples.names({"x"});
+    for(unsigned int row=0;row<rows;row++) samples.append({1e6+std::sin(row*0.7)*3},0);
+    return samples;
+}
+
+/**
+ * Replicate for a sample: the value, its square root and a constant
+ */
+void simulate(const Sample& sample, Predictive::Replicate& replicate){
+    double x = sample[0];
+    replicate[0] = {x,std::sqrt(x),2};
+}
+
+/**
+ * Check results against means and standard deviations calculated
+ * using two passes over all replicates
+ */
+void check(const Predictive& predictive, const Samples& samples, unsigned int thin){
+    const Values observed = {1e6,1000,2};
+    std::vector<Values> replicates;
+    for(unsigned int row=0;row<samples.rows();row+=thin){
+        Predictive::Replicate replicate(1);
+        simulate(samples[row],replicate);
+        Values values = replicate[0];
+        values.push_back(values[0]+values[1]+values[2]);
+        replicates.push_back(values);
+    }
+    double count = replicates.size();
+
+    auto& series = predictive.series("a");
+    BOOST_REQUIRE_EQUAL(series.count,replicates.size());
+    Values sds = series.sds();
+    Values ps = series.ps();
+    for(unsigned int index=0;index<4;index++){
+        double mean = 0;
+        for(auto& values : replicates) mean += values[index];
+        mean /= count;
+        double ss = 0;
+        double greater = 0;
+        double target = index<3?observed[index]:1e6+1000+2;
+        for(auto& values : replicates){
+            ss += std::pow(values[index]-mean,2);
+            greater += values[index]>target?1:(values[index]==target?0.5:0);
+        }
+        double sd = std::sqrt(ss/(count-1));
+
+        if(index<3){
+            BOOST_CHECK_CLOSE(series.means[index],mean,1e-10);
+            if(sd>0) BOOST_CHECK_CLOSE(sds[index],sd,1e-6);
+            else BOOST_CHECK_EQUAL(sds[index],0);
+            BOOST_CHECK_EQUAL(ps[index],greater/count);
+        } else {
+            BOOST_CHECK_CLOSE(series.statistic_mean,mean,1e-10);
+            BOOST_CHECK_CLOSE(series.statistic_sd(),sd,1e-6);
+            BOOST_CHECK_EQUAL(series.p(),greater/count);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(merging){
+    Samples samples = example(1001);
+    for(unsigned int threads : {1u,3u,8u}){
+        for(unsigned int thin : {1u,7u}){
+            Predictive predictive;
+            predictive.series("a",{1e6,1000,2});
+            predictive.threads = threads;
+            predictive.thin = thin;
+            predictive.run(samples,simulate);
+            BOOST_CHECK_EQUAL(predictive.failures,0u);
+            check(predictive,samples,thin);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(failures){
+    Samples samples = example(100);
+    Predictive predictive;
+    predictive.series("a",{1e6,1000,2});
+    predictive.threads = 4;
+    predictive.run(samples,[](const Sample& sample, Predictive::Replicate& replicate){
+        if(sample[0]<1e6-2) throw std::runtime_error("fail");
+        if(sample[0]>1e6+2) replicate[0] = {1};
+        else simulate(sample,replicate);
+    });
+    unsigned long ok = 0;
+    for(unsigned int row=0;row<samples.rows();row++){
+        double x = samples.get(row,0u);
+        if(x>=1e6-2 and x<=1e6+2) ok++;
+    }
+    BOOST_CHECK_EQUAL(predictive.series("a").count,ok);
+    BOOST_CHECK_EQUAL(predictive.failures,samples.rows()-ok);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
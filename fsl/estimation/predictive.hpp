@@ -0,0 +1,327 @@
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <mutex>
+
+#include <fsl/parallel.hpp>
+#include <fsl/estimation/sink.hpp>
+
+namespace Fsl {
+namespace Estimation {
+
+/**
+ * Posterior predictive checks over `Samples`
+ *
+ * For each of a (thinned) subset of samples, `simulate` is called to load the
+ * sample into a model, run it and simulate observations for each data series
+ * (e.g. using the `Monitoring` classes, `Cpue`, `AgeCatchSampling` etc). For example,
+ *
+ *     Predictive predictive;
+ *     predictive.series("cpue",cpue_observed);
+ *     predictive.run(samples,[&](const Sample& sample, Predictive::Replicate& replicate){
+ *         Model model = base;
+ *         model.parameters.load(sample);
+ *         model.run();
+ *         replicate[0] = values_of(model.cpue.series);
+ *     });
+ *     predictive.write("predictive.tsv");
+ *
+ * Samples are processed in parallel, so `simulate` must be safe to call concurrently
+ * (e.g. by using a copy of the model as above). Replicates are not kept: each thread accumulates
+ * the mean and variance of each simulated value (Welford's algorithm), and counts of
+ * simulated values greater than those observed, which are merged at the end (Chan et al.'s algorithm).
+ * So memory use is independent of the number of samples.
+ *
+ * For each series, the posterior predictive p-value of each observation is the
+ * proportion of replicates greater than it (counting ties as one half) and the p-value
+ * of the series is the same for a summary `statistic` of the whole series (by default the sum).
+ * p-values near 0 or 1 indicate lack of fit (p-values of missing observations are NaN). Values of the
+ * statistic for each replicate can be streamed to a file using `stream()`, in no particular order.
+ */
+class Predictive {
+public:
+
+    /**
+     * Simulated values for each series, in the order that series were added
+     */
+    typedef std::vector<Values> Replicate;
+
+    /**
+     * A data series and the accumulated results for it
+     */
+    struct Series {
+        std::string name;
+        Values observed;
+        std::function<double (const Values&)> statistic;
+
+        /**
+         * Number of replicates
+         */
+        unsigned long count = 0;
+
+        /**
+         * Mean and sum of squared deviations of simulated values
+         */
+        Values means;
+        Values m2s;
+
+        /**
+         * Number of simulated values greater than those observed (ties count one half)
+         */
+        Values greaters;
+
+        /**
+         * As above, for the summary statistic
+         */
+        double statistic_observed = NAN;
+        double statistic_mean = 0;
+        double statistic_m2 = 0;
+        double statistic_greater = 0;
+
+        Values sds(void) const {
+            Values sds(means.size(),NAN);
+            if(count>1) for(unsigned int index=0;index<sds.size();index++) sds[index] = std::sqrt(m2s[index]/(count-1));
+            return sds;
+        }
+
+        Values ps(void) const {
+            Values ps(means.size(),NAN);
+            if(count>0) for(unsigned int index=0;index<ps.size();index++) ps[index] = greaters[index]/count;
+            return ps;
+        }
+
+        double statistic_sd(void) const {
+            return count>1?std::sqrt(statistic_m2/(count-1)):NAN;
+        }
+
+        double p(void) const {
+            return count>0?statistic_greater/count:NAN;
+        }
+    };
+
+    /**
+     * Use every `thin`th sample
+     */
+    unsigned int thin = 1;
+
+    /**
+     * Number of threads. 0 for number of hardware threads.
+     */
+    unsigned int threads = 0;
+
+    /**
+     * Number of samples for which `simulate` threw an exception or did not
+     * return the same number of values as observed for all series
+     */
+    unsigned long failures = 0;
+
+    /**
+     * Sink for statistics of each replicate (see `stream()`)
+     */
+    Sink sink;
+
+    /**
+     * Add a data series
+     *
+     * @param name      Name of the series
+     * @param observed  Observed values. Missing observations can be NaN.
+     * @param statistic Summary statistic of the series. Defaults to the sum of values
+     *                  (of those not missing in `observed`)
+     */
+    Predictive& series(const std::string& name, const Values& observed, std::function<double (const Values&)> statistic = nullptr){
+        Series series;
+        series.name = name;
+        series.observed = observed;
+        if(statistic) series.statistic = statistic;
+        else {
+            series.statistic = [observed](const Values& values){
+                double sum = 0;
+                for(unsigned int index=0;index<values.size();index++){
+                    if(index<observed.size() and std::isfinite(observed[index])) sum += values[index];
+                }
+                return sum;
+            };
+        }
+        series_.push_back(series);
+        return *this;
+    }
+
+    const std::vector<Series>& series(void) const {
+        return series_;
+    }
+
+    const Series& series(const std::string& name) const {
+        for(auto& series : series_) if(series.name==name) return series;
+        throw std::runtime_error("`Predictive::series` : no series named <"+name+">");
+    }
+
+    /**
+     * Stream the summary statistic of each series for each replicate to a file
+     */
+    Predictive& stream(const std::string& path, Sink::Encoding encoding = Sink::tsv){
+        std::vector<std::string> names = {"sample"};
+        for(auto& series : series_) names.push_back(series.name);
+        sink.encoding = encoding;
+        sink.open(path,names);
+        return *this;
+    }
+
+    /**
+     * Run the checks
+     *
+     * @param samples  Samples to use
+     * @param simulate Function, with signature `void (const Sample&, Replicate&)`, which
+     *                 simulates a replicate for a sample
+     */
+    template<class Simulate>
+    Predictive& run(const Samples& samples, Simulate simulate){
+        for(auto& series : series_) reset_(series);
+        failures = 0;
+
+        unsigned int step = std::max(thin,1u);
+        unsigned int rows = (samples.rows()+step-1)/step;
+
+        // Each chunk of rows has its own accumulators which are merged at the end
+        unsigned int chunks = std::min(rows,Parallel::threads(threads)*4);
+        std::vector<std::vector<Series>> accumulators(chunks,series_);
+        for(auto& accumulator : accumulators) for(auto& series : accumulator) reset_(series);
+        std::vector<unsigned long> chunk_failures(chunks,0);
+        std::mutex sink_mutex;
+
+        Parallel::each(chunks,[&](unsigned int chunk){
+            std::vector<Series>& accumulator = accumulators[chunk];
+            Replicate replicate(series_.size());
+            Values statistics(series_.size()+1);
+            for(unsigned int row=chunk;row<rows;row+=chunks){
+                unsigned int index = row*step;
+                for(auto& values : replicate) values.clear();
+                bool ok = true;
+                try {
+                    simulate(samples[index],replicate);
+                } catch(...){
+                    ok = false;
+                }
+                for(unsigned int which=0;ok and which<series_.size();which++){
+                    ok = replicate[which].size()==series_[which].observed.size();
+                }
+                if(not ok){
+                    chunk_failures[chunk]++;
+                    continue;
+                }
+                statistics[0] = index;
+                for(unsigned int which=0;which<series_.size();which++){
+                    statistics[which+1] = add_(accumulator[which],replicate[which]);
+                }
+                if(sink.is_open()){
+                    std::lock_guard<std::mutex> lock(sink_mutex);
+                    sink.push(statistics);
+                }
+            }
+        },threads);
+
+        for(unsigned int which=0;which<series_.size();which++){
+            Series& series = series_[which];
+            for(auto& accumulator : accumulators) merge_(series,accumulator[which]);
+        }
+        for(auto count : chunk_failures) failures += count;
+        if(sink.is_open()) sink.flush();
+        return *this;
+    }
+
+    /**
+     * Write a table of results with a row for each observation, and
+     * for the summary statistic, of each series
+     */
+    const Predictive& write(const std::string& path) const {
+        std::ofstream file(path);
+        file<<"series\telement\tobserved\tmean\tsd\tp"<<std::endl;
+        for(auto& series : series_){
+            Values sds = series.sds();
+            Values ps = series.ps();
+            for(unsigned int index=0;index<series.observed.size();index++){
+                file<<series.name<<"\t"<<index<<"\t"<<series.observed[index]<<"\t"
+                    <<(series.count>0?series.means[index]:NAN)<<"\t"<<sds[index]<<"\t"<<ps[index]<<std::endl;
+            }
+            file<<series.name<<"\tstatistic\t"<<series.statistic_observed<<"\t"
+                <<(series.count>0?series.statistic_mean:NAN)<<"\t"<<series.statistic_sd()<<"\t"<<series.p()<<std::endl;
+        }
+        return *this;
+    }
+
+private:
+
+    std::vector<Series> series_;
+
+    static void reset_(Series& series){
+        unsigned int size = series.observed.size();
+        series.count = 0;
+        series.means.assign(size,0);
+        series.m2s.assign(size,0);
+        series.greaters.assign(size,0);
+        series.statistic_observed = series.statistic(series.observed);
+        series.statistic_mean = 0;
+        series.statistic_m2 = 0;
+        series.statistic_greater = 0;
+    }
+
+    static double greater_(double simulated, double observed){
+        if(std::isnan(observed)) return NAN;
+        if(simulated>observed) return 1;
+        if(simulated==observed) return 0.5;
+        return 0;
+    }
+
+    /**
+     * Add a replicate to a series' accumulators
+     *
+     * @returns The summary statistic of the replicate
+     */
+    static double add_(Series& series, const Values& values){
+        series.count++;
+        double count = series.count;
+        for(unsigned int index=0;index<values.size();index++){
+            double diff = values[index]-series.means[index];
+            series.means[index] += diff/count;
+            series.m2s[index] += diff*(values[index]-series.means[index]);
+            series.greaters[index] += greater_(values[index],series.observed[index]);
+        }
+        double statistic = series.statistic(values);
+        double diff = statistic-series.statistic_mean;
+        series.statistic_mean += diff/count;
+        series.statistic_m2 += diff*(statistic-series.statistic_mean);
+        series.statistic_greater += greater_(statistic,series.statistic_observed);
+        return statistic;
+    }
+
+    /**
+     * Merge accumulators for a series into another
+     */
+    static void merge_(Series& into, const Series& from){
+        if(from.count==0) return;
+        if(into.count==0){
+            Series merged = from;
+            merged.name = into.name;
+            merged.statistic = into.statistic;
+            into = merged;
+            return;
+        }
+        double a = into.count;
+        double b = from.count;
+        double n = a+b;
+        for(unsigned int index=0;index<into.means.size();index++){
+            double delta = from.means[index]-into.means[index];
+            into.means[index] += delta*b/n;
+            into.m2s[index] += from.m2s[index] + delta*delta*a*b/n;
+            into.greaters[index] += from.greaters[index];
+        }
+        double delta = from.statistic_mean-into.statistic_mean;
+        into.statistic_mean += delta*b/n;
+        into.statistic_m2 += from.statistic_m2 + delta*delta*a*b/n;
+        into.statistic_greater += from.statistic_greater;
+        into.count += from.count;
+    }
+};
+
+} // namespace Estimation
+} // namespace Fsl
@@ -0,0 +1,130 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/estimation/sink.hpp>
+
+BOOST_AUTO_TEST_SUITE(sink)
+
+using namespace Fsl::Estimation;
+
+BOOST_AUTO_TEST_CASE(tsv){
+    std::string path = (boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string();
+
+    Sink sink;
+    sink.burnin = 10;
+    sink.thin = 3;
+    sink.open(path,{"a","likelihood"});
+    for(int row=0;row<20;row++) sink.push({row*0.1},-row);
+    sink.close();
+    BOOST_CHECK_EQUAL(sink.pushed(),20u);
+    BOOST_CHECK_EQUAL(sink.written(),4u);
+
+    // Appending continues the file
+    sink.burnin = 0;
+    sink.thin = 1;
+    sink.open(path,{"a","likelihood"});
+    sink.push({0.1},-1);
+    sink.close();
+
+    std::ifstream file(path);
+    std::string line;
+    std::vector<std::string> lines;
+    while(std::getline(file,line)) lines.push_back(line);
+    BOOST_CHECK_EQUAL(lines.size(),6u);
+    BOOST_CHECK_EQUAL(lines[0],"a\tlikelihood");
+    BOOST_CHECK_EQUAL(lines[1],"1\t-10");
+    BOOST_CHECK_EQUAL(lines[4],"1.9000000000000001\t-19");
+    BOOST_CHECK_EQUAL(lines[5],"0.10000000000000001\t-1");
+
+    // Different names are an error
+    BOOST_CHECK_THROW(sink.open(path,{"b","likelihood"}),std::runtime_error);
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(tsv_checked_before_truncation){
+    std::string path = (boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string();
+    auto contents = [&path](void){
+        std::ifstream file(path,std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+    };
+
+    // A file with a partially written last line...
+    {
+        std::ofstream file(path);
+        file<<"a\tlikelihood\n1\t-1\n2\t-";
+    }
+    // ...is not modified if names differ
+    Sink sink;
+    BOOST_CHECK_THROW(sink.open(path,{"b","likelihood"}),std::runtime_error);
+    BOOST_CHECK_EQUAL(contents(),"a\tlikelihood\n1\t-1\n2\t-");
+    // ...or if it has a different encoding
+    sink.encoding = Sink::binary;
+    BOOST_CHECK_THROW(sink.open(path,{"a","likelihood"}),std::runtime_error);
+    BOOST_CHECK_EQUAL(contents(),"a\tlikelihood\n1\t-1\n2\t-");
+
+    // ...but is truncated when appended to
+    sink.encoding = Sink::tsv;
+    sink.open(path,{"a","likelihood"});
+    sink.push({3},-3);
+    sink.close();
+    BOOST_CHECK_EQUAL(contents(),"a\tlikelihood\n1\t-1\n3\t-3\n");
+
+    // A partially written header is not emptied
+    {
+        std::ofstream file(path);
+        file<<"a\tlike";
+    }
+    BOOST_CHECK_THROW(sink.open(path,{"a","likelihood"}),std::runtime_error);
+    BOOST_CHECK_EQUAL(contents(),"a\tlike");
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(binary){
+    std::string path = (boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string();
+
+    Sink sink;
+    sink.encoding = Sink::binary;
+    sink.open(path,{"a","b"});
+    for(int row=0;row<5;row++) sink.push({double(row),row*2.0});
+    sink.close();
+
+    // Simulate a partially written row, which is truncated when reopened
+    std::size_t size = boost::filesystem::file_size(path);
+    {
+        std::ofstream file(path,std::ios::binary|std::ios::app);
+        file.write("xyz",3);
+    }
+    sink.open(path,{"a","b"});
+    sink.push({5,10});
+    sink.close();
+    BOOST_CHECK_EQUAL(boost::filesystem::file_size(path),size+2*sizeof(double));
+
+    std::ifstream file(path,std::ios::binary);
+    file.seekg(size-2*sizeof(double));
+    double values[4];
+    file.read(reinterpret_cast<char*>(values),sizeof(values));
+    BOOST_CHECK_EQUAL(values[0],4);
+    BOOST_CHECK_EQUAL(values[1],8);
+    BOOST_CHECK_EQUAL(values[2],5);
+    BOOST_CHECK_EQUAL(values[3],10);
+
+    // Different encoding or names are an error and the file is not
+    // modified, even if it has a partially written row
+    {
+        std::ofstream file(path,std::ios::binary|std::ios::app);
+        file.write("xyz",3);
+    }
+    sink.encoding = Sink::tsv;
+    BOOST_CHECK_THROW(sink.open(path,{"a","b"}),std::runtime_error);
+    sink.encoding = Sink::binary;
+    BOOST_CHECK_THROW(sink.open(path,{"a","c"}),std::runtime_error);
+    BOOST_CHECK_EQUAL(boost::filesystem::file_size(path),size+2*sizeof(double)+3);
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,358 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace Fsl {
+namespace Estimation {
+
+/**
+ * An append-only, streaming sink for rows of samples
+ *
+ * Rows are written to the end of a file as they are pushed so that memory use is
+ * constant and I/O is proportional to the number of new rows (rather than rewriting
+ * all samples every so often). The first `burnin` rows pushed are discarded and
+ * then only every `thin`th row is written. Every `sync` written rows the file is flushed
+ * and synced to disk so that, if a run is interrupted, at most `sync` rows are lost.
+ *
+ * If the file already exists, rows are appended to it (after checking that it has the same
+ * columns) so that a chain can be continued across runs.
+ *
+ * Files can be written in one of two encodings:
+ *
+ *   - `tsv` : a header line of names followed by tab separated values (as written by `Samples::write()`)
+ *   - `binary` : a header followed by rows of doubles (see below)
+ *
+ * Both can be read using `Samples::read()`.
+ */
+class Sink {
+public:
+
+    enum Encoding {
+        tsv,
+        binary
+    };
+
+    /**
+     * @name Binary format
+     *
+     * A binary stream file has a header followed by rows of values:
+     *
+     *   - `magic` : 8 bytes, `FSLSTRM1`
+     *   - `columns` : uint32, number of columns
+     *   - `version` : uint32, currently 1
+     *   - for each column, `type` (uint32, 1 = float64), name length (uint32) and name bytes
+     *   - rows of `columns` float64 values
+     *
+     * Unlike binary samples files (see `Samples::write_binary()`), rows are stored
+     * contiguously so that the file can be appended to. Numbers are in the native byte order
+     * of the machine which wrote the file.
+     *
+     * @{
+     */
+
+    static const char* magic(void) {
+        return "FSLSTRM1";
+    }
+
+    static const uint32_t version = 1;
+    static const uint32_t float64 = 1;
+
+    /**
+     * Encode column descriptors (`type`, name length and name for each column). The same
+     * descriptors are used in binary samples files.
+     */
+    static std::string descriptors(const std::vector<std::string>& names){
+        std::string bytes;
+        uint32_t type = float64;
+        for(auto& name : names){
+            uint32_t length = name.length();
+            bytes.append(reinterpret_cast<const char*>(&type),4);
+            bytes.append(reinterpret_cast<const char*>(&length),4);
+            bytes.append(name);
+        }
+        return bytes;
+    }
+
+    /**
+     * Decode column descriptors
+     *
+     * @param data     Start of the file
+     * @param size     Size of the file
+     * @param position Position of the first descriptor, advanced past the last
+     * @param columns  Number of columns
+     * @param error    Function which creates an exception from a message
+     */
+    template<class Error>
+    static std::vector<std::string> descriptors(const char* data, std::size_t size, std::size_t& position, uint32_t columns, Error error){
+        std::vector<std::string> names;
+        for(uint32_t column=0;column<columns;column++){
+            uint32_t type;
+            uint32_t length;
+            if(position+8>size) throw error("truncated header");
+            std::memcpy(&type,data+position,4);
+            std::memcpy(&length,data+position+4,4);
+            position += 8;
+            if(type!=float64) throw error("unsupported column type");
+            if(position+length>size) throw error("truncated header");
+            names.push_back(std::string(data+position,length));
+            position += length;
+        }
+        return names;
+    }
+
+    /**
+     * Decode the header of a binary stream file
+     *
+     * @param data   Start of the file
+     * @param size   Size of the file
+     * @param offset Set to the position of the first row
+     * @param error  Function which creates an exception from a message
+     * @returns Column names
+     */
+    template<class Error>
+    static std::vector<std::string> header(const char* data, std::size_t size, std::size_t& offset, Error error){
+        if(size<16 or std::memcmp(data,magic(),8)!=0) throw error("invalid header");
+        uint32_t columns;
+        uint32_t version_;
+        std::memcpy(&columns,data+8,4);
+        std::memcpy(&version_,data+12,4);
+        if(version_!=version) throw error("unsupported version");
+        offset = 16;
+        return descriptors(data,size,offset,columns,error);
+    }
+
+    /**
+     * @}
+     */
+
+    /**
+     * Encoding of the file
+     */
+    Encoding encoding = tsv;
+
+    /**
+     * Number of rows to discard before writing
+     */
+    unsigned long burnin = 0;
+
+    /**
+     * Write every `thin`th row after burn-in
+     */
+    unsigned int thin = 1;
+
+    /**
+     * Flush and sync to disk every `sync` written rows. 0 for only
+     * when `flush()` is called or the sink is closed
+     */
+    unsigned int sync = 1000;
+
+    Sink(void){
+    }
+
+    Sink(const std::string& path, const std::vector<std::string>& names, Encoding encoding = tsv):
+        encoding(encoding){
+        open(path,names);
+    }
+
+    /**
+     * Open a file for appending rows with the given column names
+     */
+    Sink& open(const std::string& path, const std::vector<std::string>& names){
+        close();
+        names_ = names;
+        pushed_ = 0;
+        written_ = 0;
+
+        bool exists = boost::filesystem::exists(path) and boost::filesystem::file_size(path)>0;
+        if(exists) check_(path);
+
+        std::FILE* file = std::fopen(path.c_str(),encoding==binary?"ab":"a");
+        if(not file) throw std::runtime_error("`Sink::open` : could not open file <"+path+">");
+        file_.reset(file,std::fclose);
+        path_ = path;
+
+        if(not exists) header_();
+        return *this;
+    }
+
+    bool is_open(void) const {
+        return static_cast<bool>(file_);
+    }
+
+    const std::string& path(void) const {
+        return path_;
+    }
+
+    const std::vector<std::string>& names(void) const {
+        return names_;
+    }
+
+    /**
+     * Number of rows pushed and written since the sink was opened
+     */
+    unsigned long pushed(void) const {
+        return pushed_;
+    }
+
+    unsigned long written(void) const {
+        return written_;
+    }
+
+    /**
+     * Push a row of values
+     *
+     * @returns Whether or not the row was written (i.e. was not discarded
+     *          by burn-in or thinning)
+     */
+    bool push(const double* values, std::size_t size){
+        if(not file_) throw std::runtime_error("`Sink::push` : sink is not open");
+        if(size!=names_.size()) throw std::runtime_error("`Sink::push` : expected <"+std::to_string(names_.size())+"> values but got <"+std::to_string(size)+">");
+
+        unsigned long index = pushed_++;
+        if(index<burnin) return false;
+        if(thin>1 and (index-burnin)%thin!=0) return false;
+
+        std::FILE* file = file_.get();
+        bool ok = true;
+        if(encoding==binary){
+            ok = std::fwrite(values,sizeof(double),size,file)==size;
+        } else {
+            for(std::size_t column=0;column<size;column++){
+                ok = ok and std::fprintf(file,column==0?"%.17g":"\t%.17g",values[column])>0;
+            }
+            ok = ok and std::fputc('\n',file)!=EOF;
+        }
+        if(not ok) throw std::runtime_error("`Sink::push` : error writing to file <"+path_+">");
+
+        written_++;
+        if(sync>0 and written_%sync==0) flush();
+        return true;
+    }
+
+    bool push(const std::vector<double>& values){
+        return push(values.data(),values.size());
+    }
+
+    /**
+     * Push a row of values followed by a likelihood (for a sink with
+     * names of values followed by `likelihood`, as read by `Samples::read()`)
+     */
+    bool push(const std::vector<double>& values, double likelihood){
+        buffer_.assign(values.begin(),values.end());
+        buffer_.push_back(likelihood);
+        return push(buffer_.data(),buffer_.size());
+    }
+
+    /**
+     * Flush buffered rows and sync the file to disk
+     */
+    Sink& flush(void){
+        if(file_){
+            std::fflush(file_.get());
+            ::fsync(::fileno(file_.get()));
+        }
+        return *this;
+    }
+
+    Sink& close(void){
+        if(file_){
+            flush();
+            file_.reset();
+        }
+        return *this;
+    }
+
+    ~Sink(void){
+        if(file_ and file_.unique()) flush();
+    }
+
+private:
+
+    std::shared_ptr<std::FILE> file_;
+    std::string path_;
+    std::vector<std::string> names_;
+    unsigned long pushed_ = 0;
+    unsigned long written_ = 0;
+    std::vector<double> buffer_;
+
+    void header_(void){
+        std::FILE* file = file_.get();
+        if(encoding==binary){
+            uint32_t columns = names_.size();
+            uint32_t version_ = version;
+            std::string bytes = descriptors(names_);
+            std::fwrite(magic(),1,8,file);
+            std::fwrite(&columns,4,1,file);
+            std::fwrite(&version_,4,1,file);
+            std::fwrite(bytes.data(),1,bytes.size(),file);
+        } else {
+            for(unsigned int column=0;column<names_.size();column++){
+                std::fprintf(file,column==0?"%s":"\t%s",names_[column].c_str());
+            }
+            std::fputc('\n',file);
+        }
+        flush();
+    }
+
+    /**
+     * Check that an existing file has the same encoding and names and
+     * truncate any partially written last row (e.g. after a crash) so that
+     * appended rows are aligned. The file is only modified once it has been checked.
+     */
+    void check_(const std::string& path){
+        auto error = [&path](const std::string& message){
+            return std::runtime_error("`Sink::open` : "+message+" in existing file <"+path+">");
+        };
+        std::size_t size = boost::filesystem::file_size(path);
+        std::size_t end = size;
+        {
+            using namespace boost::interprocess;
+            file_mapping file(path.c_str(),read_only);
+            mapped_region region(file,read_only);
+            const char* data = static_cast<const char*>(region.get_address());
+
+            bool is_binary = size>=8 and std::memcmp(data,magic(),8)==0;
+            if(is_binary!=(encoding==binary)) throw error("different encoding");
+
+            std::vector<std::string> names;
+            if(is_binary){
+                std::size_t offset;
+                names = header(data,size,offset,error);
+                std::size_t row = names.size()*sizeof(double);
+                if(row>0) end = offset+(size-offset)/row*row;
+            } else {
+                const char* newline = static_cast<const char*>(std::memchr(data,'\n',size));
+                // A header line without a newline is incomplete and will not match
+                std::size_t length = newline?newline-data:size;
+                std::size_t start = 0;
+                while(true){
+                    const char* tab = static_cast<const char*>(std::memchr(data+start,'\t',length-start));
+                    std::size_t stop = tab?tab-data:length;
+                    names.push_back(std::string(data+start,stop-start));
+                    if(not tab) break;
+                    start = stop+1;
+                }
+                // Drop any partially written last line
+                while(end>0 and data[end-1]!='\n') end--;
+            }
+            if(names!=names_) throw error("different names");
+        }
+        if(end<size) boost::filesystem::resize_file(path,end);
+    }
+};
+
+} // namespace Estimation
+} // namespace Fsl
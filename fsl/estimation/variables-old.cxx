@@ -0,0 +1,357 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/probability/normal.hpp>
+#include <fsl/math/probability/uniform.hpp>
+#include <fsl/math/probability/lognormal.hpp>
+#include <fsl/estimation/variables-old.hpp>
+
+BOOST_AUTO_TEST_SUITE(samples)
+
+using namespace Fsl::Estimation;
+
+std::string temporary(void){
+    return (boost::filesystem::temp_directory_path()/boost::filesystem::unique_path()).string();
+}
+
+Samples example(void){
+    Samples samples;
+    samples.names({"a","b","c"});
+    for(int row=0;row<5;row++) samples.append({row*0.1,row*-2.5,row+1e-10},-row*1.5);
+    return samples;
+}
+
+void check_equal(const Samples& actual, const Samples& expected){
+    BOOST_REQUIRE_EQUAL(actual.rows(),expected.rows());
+    BOOST_REQUIRE_EQUAL(actual.columns(),expected.columns());
+    BOOST_CHECK(actual.names()==expected.names());
+    for(unsigned int row=0;row<expected.rows();row++){
+        for(unsigned int column=0;column<expected.columns();column++){
+            BOOST_CHECK_EQUAL(actual.get(row,column),expected.get(row,column));
+        }
+        BOOST_CHECK_EQUAL(actual.likelihood(row),expected.likelihood(row));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(binary_round_trip){
+    Samples original = example();
+    std::string path = temporary();
+    original.write_binary(path);
+
+    Samples mapped;
+    mapped.map(path);
+    BOOST_CHECK(mapped.mapped());
+    check_equal(mapped,original);
+    BOOST_CHECK_EQUAL(mapped.column(1)[3],-7.5);
+
+    // `read()` detects binary files and maps them
+    Samples read;
+    read.read(path);
+    BOOST_CHECK(read.mapped());
+    check_equal(read,original);
+
+    // Mapped samples are read-only
+    BOOST_CHECK_THROW(mapped.append({1,2,3}),std::runtime_error);
+    BOOST_CHECK_THROW(mapped.remove(0u),std::runtime_error);
+
+    // Writing mapped samples gives an identical file
+    std::string copy = temporary();
+    mapped.write_binary(copy);
+    Samples remapped;
+    remapped.map(copy);
+    check_equal(remapped,original);
+
+    boost::filesystem::remove(path);
+    boost::filesystem::remove(copy);
+}
+
+BOOST_AUTO_TEST_CASE(binary_corrupt){
+    Samples original = example();
+    std::string path = temporary();
+    original.write_binary(path);
+
+    // Row counts which are too large for the file, including ones for which the
+    // size of the data (4 x 8 x rows) overflows 64 bits to a small number
+    for(uint64_t rows : {uint64_t(6),uint64_t(1)<<61,(uint64_t(1)<<61)+1}){
+        std::fstream file(path,std::ios::in|std::ios::out|std::ios::binary);
+        file.seekp(16);
+        file.write(reinterpret_cast<const char*>(&rows),8);
+        file.close();
+        Samples mapped;
+        BOOST_CHECK_THROW(mapped.map(path),std::runtime_error);
+    }
+
+    // Data offset beyond the end of the file
+    uint64_t rows = 5;
+    uint64_t offset = 1<<20;
+    std::fstream file(path,std::ios::in|std::ios::out|std::ios::binary);
+    file.seekp(16);
+    file.write(reinterpret_cast<const char*>(&rows),8);
+    file.write(reinterpret_cast<const char*>(&offset),8);
+    file.close();
+    Samples mapped;
+    BOOST_CHECK_THROW(mapped.map(path),std::runtime_error);
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(text_header){
+    Samples original = example();
+    std::string path = temporary();
+    original.write(path);
+
+    Samples read;
+    read.read(path);
+    BOOST_CHECK(not read.mapped());
+    BOOST_CHECK(read.names()==original.names());
+    BOOST_REQUIRE_EQUAL(read.rows(),original.rows());
+    BOOST_CHECK_CLOSE(read.get(4,1),-10,1e-10);
+    BOOST_CHECK_CLOSE(read.likelihood(4),-6,1e-10);
+
+    // Without a header, current names are used
+    std::ofstream(path)<<"1 2 -3\n4 5 -6\n";
+    Samples headless;
+    headless.names({"x","y"});
+    headless.read(path,false);
+    BOOST_CHECK(headless.names()==std::vector<std::string>({"x","y"}));
+    BOOST_REQUIRE_EQUAL(headless.rows(),2u);
+    BOOST_CHECK_EQUAL(headless.get(1,"y"),5);
+    BOOST_CHECK_EQUAL(headless.likelihood(1),-6);
+
+    // ... which must match the number of columns
+    Samples unnamed;
+    BOOST_CHECK_THROW(unnamed.read(path,false),std::runtime_error);
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(stream){
+    // Binary stream files written by a `Sink` are read into memory
+    std::string path = temporary();
+    Sink sink(path,{"a","b","likelihood"},Sink::binary);
+    for(int row=0;row<5;row++) sink.push({row*0.1,row*-2.5},-row*1.5);
+    sink.close();
+    {
+        // A partially written row is ignored
+        std::ofstream file(path,std::ios::binary|std::ios::app);
+        file.write("xyz",3);
+    }
+
+    Samples samples;
+    samples.read(path);
+    BOOST_CHECK(not samples.mapped());
+    BOOST_CHECK(samples.names()==std::vector<std::string>({"a","b"}));
+    BOOST_REQUIRE_EQUAL(samples.rows(),5u);
+    BOOST_CHECK_EQUAL(samples.get(3,"a"),3*0.1);
+    BOOST_CHECK_EQUAL(samples.get(4,"b"),-10);
+    BOOST_CHECK_EQUAL(samples.likelihood(2),-3);
+
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(remove){
+    Samples samples = example();
+    samples.remove(1u);
+    BOOST_REQUIRE_EQUAL(samples.rows(),4u);
+    // Last row is moved into the removed row
+    BOOST_CHECK_EQUAL(samples.get(1,0),4*0.1);
+    BOOST_CHECK_EQUAL(samples.likelihood(1),-6);
+    BOOST_CHECK_EQUAL(samples.get(3,0),3*0.1);
+
+    samples.remove(samples[3]);
+    BOOST_REQUIRE_EQUAL(samples.rows(),3u);
+    BOOST_CHECK_EQUAL(samples.get(2,"b"),-5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(set)
+
+using namespace Fsl::Estimation;
+using Fsl::Math::Probability::Uniform;
+using Fsl::Math::Probability::Lognormal;
+using Fsl::Math::Probability::Normal;
+
+class Example : public Set<Example> {
+public:
+    Variable<Uniform> a = Uniform(0,10);
+    Variable<Uniform> b = Uniform(0,10);
+
+    Example(void):
+        Set<Example>(samples::temporary()){
+    }
+
+    template<class Mirror>
+    void reflect(Mirror& mirror){
+        mirror
+            .data(a,"a")
+            .data(b,"b")
+        ;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(load_compiled){
+    Samples samples;
+    samples.names({"a","b"});
+    samples.append({1,2},0);
+
+    Example set;
+    set.compile(samples);
+    set.load(samples[0]);
+    BOOST_CHECK_EQUAL(set.a.value(),1);
+    BOOST_CHECK_EQUAL(set.b.value(),2);
+
+    // Same number of columns but in a different order (and with values
+    // within both variates' bounds): columns of the compiled table are not used
+    Samples reordered;
+    reordered.names({"b","a"});
+    reordered.append({3,4},0);
+    set.load(reordered[0]);
+    BOOST_CHECK_EQUAL(set.a.value(),4);
+    BOOST_CHECK_EQUAL(set.b.value(),3);
+
+    // Same number of columns but different names
+    Samples renamed;
+    renamed.names({"a","c"});
+    renamed.append({5,6},0);
+    set.load(renamed[0]);
+    BOOST_CHECK_EQUAL(set.a.value(),5);
+    BOOST_CHECK_EQUAL(set.b.value(),3);
+}
+
+/**
+ * A set with variates bounded on both sides, bounded below by zero and fixed
+ */
+class Mixed : public Set<Mixed> {
+public:
+    Variable<Uniform> u = Uniform(-1,2);
+    Variable<Lognormal> l = Lognormal(1,0.5);
+    Variable<Fixed> f = 3.0;
+    Variable<Normal> n = Normal(0,1);
+
+    Mixed(void):
+        Set<Mixed>(samples::temporary()){
+    }
+
+    template<class Mirror>
+    void reflect(Mirror& mirror){
+        mirror
+            .data(u,"u")
+            .data(l,"l")
+            .data(f,"f")
+            .data(n,"n")
+        ;
+    }
+};
+
+BOOST_AUTO_TEST_CASE(transform){
+    Mixed set;
+    Links::Transform transform = set.transform();
+    // Only the free variate bounded below by zero uses the log link
+    BOOST_CHECK_EQUAL(transform.size(),4u);
+    BOOST_REQUIRE_EQUAL(transform.logs().size(),1u);
+    BOOST_CHECK_EQUAL(transform.logs()[0],1u);
+
+    std::vector<double> values = {0.5,2.5,3,-1};
+    std::vector<double> parameters = transform.from(values);
+    BOOST_CHECK_EQUAL(parameters[0],0.5);
+    BOOST_CHECK_CLOSE(parameters[1],std::log(2.5),1e-12);
+    BOOST_CHECK_EQUAL(parameters[2],3);
+    BOOST_CHECK_EQUAL(parameters[3],-1);
+    std::vector<double> round = transform.to(parameters);
+    for(unsigned int index=0;index<values.size();index++) BOOST_CHECK_CLOSE(round[index],values[index],1e-12);
+    BOOST_CHECK_CLOSE(transform.jacobian(parameters),std::log(2.5),1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(restrict_compiled){
+    // Compiled and reflection restriction give identical results
+    Mixed compiled;
+    compiled.compile();
+    Mixed reflected;
+    // Within, on and beyond bounds (the fixed variate is always its fixed value)
+    std::vector<std::vector<double>> cases = {
+        {0.5,2.5,3,-1},
+        {-1,0,3,0},
+        {2,1e300,-7,1e300},
+        {-5,-1,3.5,-INFINITY},
+        {1.9999,1e-300,3,INFINITY},
+        {std::nextafter(-1.0,0.0),std::nextafter(0.0,1.0),0,0}
+    };
+    for(auto& values : cases){
+        std::vector<double> expected = reflected.restrict(values);
+        std::vector<double> actual = compiled.restrict(values);
+        BOOST_REQUIRE_EQUAL(actual.size(),expected.size());
+        for(unsigned int index=0;index<values.size();index++){
+            // Infinite values of unbounded variates are NaN for both
+            if(std::isnan(expected[index])) BOOST_CHECK(std::isnan(actual[index]));
+            else BOOST_CHECK_EQUAL(actual[index],expected[index]);
+        }
+        BOOST_CHECK_EQUAL(actual[2],3);
+    }
+    // Values on the bounds are moved inside them
+    std::vector<double> restricted = compiled.restrict({-1,0,3,0});
+    BOOST_CHECK_CLOSE(restricted[0],-1+3*0.0001,1e-10);
+    BOOST_CHECK(restricted[1]>0);
+
+    // A change in the fixed value is seen by the compiled version
+    compiled.f = 4.0;
+    reflected.f = 4.0;
+    BOOST_CHECK_EQUAL(compiled.restrict(cases[0])[2],4);
+    BOOST_CHECK_EQUAL(reflected.restrict(cases[0])[2],4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(links)
+
+using namespace Fsl::Estimation;
+
+BOOST_AUTO_TEST_CASE(log){
+    Links::Log link;
+    std::vector<double> parameters = {-100,-46.5,-46,-1,0,0.5,10,46,46.5,100};
+    std::vector<double> variables(parameters.size());
+    link.to(parameters.data(),variables.data(),parameters.size());
+    for(unsigned int index=0;index<parameters.size();index++){
+        BOOST_CHECK_EQUAL(variables[index],link.to(parameters[index]));
+    }
+    BOOST_CHECK_EQUAL(variables[0],std::exp(-46));
+    BOOST_CHECK_EQUAL(variables[9],std::exp(46));
+
+    std::vector<double> back(variables.size());
+    link.from(variables.data(),back.data(),variables.size());
+    for(unsigned int index=0;index<variables.size();index++){
+        BOOST_CHECK_EQUAL(back[index],link.from(variables[index]));
+        if(std::fabs(parameters[index])<=46) BOOST_CHECK_SMALL(back[index]-parameters[index],1e-14*std::max(std::fabs(parameters[index]),1.0));
+    }
+
+    // Batch conversion in place
+    std::vector<double> values = parameters;
+    link.to(values.data(),values.data(),values.size());
+    BOOST_CHECK(values==variables);
+}
+
+BOOST_AUTO_TEST_CASE(jacobian){
+    Links::Log link;
+    // Log of the derivative of `to()` by central differences
+    for(double value : {-45.0,-3.0,0.0,0.7,20.0,45.0}){
+        double h = 1e-6;
+        double derivative = (link.to(value+h)-link.to(value-h))/(2*h);
+        BOOST_CHECK_SMALL(link.jacobian(value)-std::log(derivative),1e-8*std::max(std::fabs(value),1.0));
+    }
+    // `to()` is constant beyond the limits
+    BOOST_CHECK_EQUAL(link.jacobian(50),-INFINITY);
+    BOOST_CHECK_EQUAL(link.jacobian(-50),-INFINITY);
+    BOOST_CHECK_EQUAL(Links::Identity().jacobian(3),0);
+
+    Links::Transform transform;
+    transform.log(2).log(0).log(2);
+    BOOST_CHECK_EQUAL(transform.size(),3u);
+    BOOST_CHECK(transform.logs()==std::vector<unsigned int>({0,2}));
+    BOOST_CHECK_EQUAL(transform.jacobian({1,5,-2}),-1);
+    BOOST_CHECK_EQUAL(transform.jacobian({1,5,60}),-INFINITY);
+    BOOST_CHECK_THROW(transform.to({1,2}),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,7 +1,18 @@
 #pragma once
 
-#include <boost/regex.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 #include <stencila/structure.hpp>
 #include <stencila/mirror.hpp>
@@ -9,10 +20,15 @@ using Stencila::Structure;
 using Stencila::Mirrors::Mirror;
 
 #include <fsl/math/probability/fixed.hpp>
+#include <fsl/math/probability/likelihoods.hpp>
+#include <fsl/estimation/parse.hpp>
+#include <fsl/estimation/sink.hpp>
 
 namespace Fsl {
 namespace Estimation {
 
+using Math::Probability::Fixed;
+
 namespace Links {
 
 struct Identity {
@@ -22,6 +38,13 @@ struct Identity {
     double from(const double& value) const {
         return value;
     }
+
+    /**
+     * Log of the absolute derivative of `to()` at `value`
+     */
+    double jacobian(const double& value) const {
+        return 0;
+    }
 };
 
 struct Log {
@@ -40,12 +63,126 @@ struct Log {
         
     }
 
+    /**
+     * Transform a contiguous array of parameters into model variables
+     *
+     * Equivalent to calling `to()` for each value but the limits are applied
+     * with `min`/`max` rather than branches so that the loop can be vectorised.
+     */
+    void to(const double* values, double* results, std::size_t size) const {
+        static const double limit = 46;
+        for(std::size_t index=0;index<size;index++){
+            results[index] = std::min(std::max(values[index],-limit),limit);
+        }
+        for(std::size_t index=0;index<size;index++){
+            results[index] = std::exp(results[index]);
+        }
+    }
+
     /**
      * Transform the model variable into a parameter
      */
     double from(const double& value) const {
         return std::log(value);
     }
+
+    void from(const double* values, double* results, std::size_t size) const {
+        for(std::size_t index=0;index<size;index++){
+            results[index] = std::log(values[index]);
+        }
+    }
+
+    /**
+     * Log of the absolute derivative of `to()` at `value` i.e. the term to add to
+     * a log density of the model variable to get the log density of the parameter.
+     * Within the limits, d/dp exp(p) = exp(p) so this is just the parameter. Outside them
+     * `to()` is constant so the derivative is zero and this is `-INFINITY`.
+     */
+    double jacobian(const double& value) const {
+        static const double limit = 46;
+        if(value<-limit or value>limit) return -INFINITY;
+        return value;
+    }
+};
+
+/**
+ * A transform of a whole vector of parameters into model variables
+ *
+ * Parameters are grouped by link so that each link is applied in a single
+ * loop over a contiguous buffer. Parameters without a link
+ * use `Identity` and are copied.
+ */
+class Transform {
+public:
+
+    Transform(unsigned int size = 0):
+        size_(size){
+    }
+
+    /**
+     * Use the log link for the parameter at `index`
+     */
+    Transform& log(unsigned int index){
+        if(index>=size_) size_ = index+1;
+        logs_.push_back(index);
+        std::sort(logs_.begin(),logs_.end());
+        logs_.erase(std::unique(logs_.begin(),logs_.end()),logs_.end());
+        return *this;
+    }
+
+    /**
+     * Indices of parameters that use the log link
+     */
+    const std::vector<unsigned int>& logs(void) const {
+        return logs_;
+    }
+
+    unsigned int size(void) const {
+        return size_;
+    }
+
+    /**
+     * Transform parameters into model variables
+     */
+    std::vector<double> to(const std::vector<double>& parameters) const {
+        return apply_(parameters,true);
+    }
+
+    /**
+     * Transform model variables into parameters
+     */
+    std::vector<double> from(const std::vector<double>& variables) const {
+        return apply_(variables,false);
+    }
+
+    /**
+     * Sum of log Jacobian terms for parameters. Add this to the log posterior of the model
+     * variables to get the log posterior of the (unconstrained) parameters.
+     */
+    double jacobian(const std::vector<double>& parameters) const {
+        Log log;
+        double sum = 0;
+        for(unsigned int index : logs_) sum += log.jacobian(parameters[index]);
+        return sum;
+    }
+
+private:
+    unsigned int size_;
+    std::vector<unsigned int> logs_;
+
+    std::vector<double> apply_(const std::vector<double>& values, bool to) const {
+        if(values.size()<size_) throw std::runtime_error(str(boost::format("Expected at least <%s> values but got <%s>.")%size_%values.size()));
+        std::vector<double> results = values;
+        if(logs_.size()>0){
+            std::vector<double> buffer(logs_.size());
+            for(unsigned int index=0;index<logs_.size();index++) buffer[index] = values[logs_[index]];
+            Log log;
+            if(to) log.to(buffer.data(),buffer.data(),buffer.size());
+            else log.from(buffer.data(),buffer.data(),buffer.size());
+            for(unsigned int index=0;index<logs_.size();index++) results[logs_[index]] = buffer[index];
+        }
+        return results;
+    }
 };
 
 } // namespace Links
@@ -91,6 +228,14 @@ public:
 
     Variate& value(const double& value);
 
+    /**
+     * Get a pointer to the value (e.g. for compiling a table of bindings
+     * by `Set::compile()`)
+     */
+    double* pointer(void) {
+        return &value_;
+    }
+
     operator double(void) const {
         return value();
     }
@@ -196,6 +341,13 @@ public:
      */
     bool has(const std::string& name) const;
 
+    /**
+     * Check the sample's columns have these names, in this order
+     * 
+     * @param  names Column names
+     */
+    bool named(const std::vector<std::string>& names) const;
+
     /**
      * Get a variate value from the sample
      * 
@@ -254,42 +406,108 @@ public:
 
 typedef std::vector<double> Values;
 
+/**
+ * A store of samples of variate values and their likelihoods
+ *
+ * Values are stored column-major: each column (and the likelihoods) is
+ * a contiguous array. A `Samples` can either own its columns (when
+ * they are appended or read from a text file) or view the columns of a
+ * binary samples file which has been memory mapped (see `write_binary()`
+ * and `map()`). Mapped samples are read-only, are opened without parsing or copying
+ * and their pages are shared between all processes that map the same file.
+ */
 class Samples {
 private:
 
     unsigned int rows_ = 0;
-    
-    struct Cell_ {
-        Values values;
-        double likelihood;
-
-        Cell_(const Values& values,const double& likelihood = NAN):
-            values(values),
-            likelihood(likelihood){
-        }
-    };
-    std::vector<Cell_> cells_;
 
     std::vector<std::string> names_;
 
+    /**
+     * Owned storage: a vector for each column and the likelihoods
+     */
+    std::vector<Values> columns_;
+    Values likelihoods_;
+
+    /**
+     * Mapped storage: pointers to each column and the likelihoods
+     * within a mapped region of a binary samples file
+     */
+    std::shared_ptr<boost::interprocess::mapped_region> region_;
+    std::vector<const double*> mapped_;
+    const double* mapped_likelihoods_ = nullptr;
+
+    void owned_(const char* method) const {
+        if(region_) throw std::runtime_error(std::string("`Samples::")+method+"` : samples are memory mapped and read-only");
+    }
+
 public:
 
+    /**
+     * @name Binary format
+     *
+     * A binary samples file has a header followed by typed columns:
+     *
+     *   - `magic` : 8 bytes, `FSLSMPL1`
+     *   - `columns` : uint32, number of variate columns
+     *   - `version` : uint32, currently 1
+     *   - `rows` : uint64, number of rows
+     *   - `offset` : uint64, byte offset of the first column
+     *   - for each column, `type` (uint32, 1 = float64), name length (uint32) and name bytes
+     *   - padding to `offset` (a multiple of 8 bytes)
+     *   - for each column, `rows` values
+     *   - `rows` likelihoods (float64)
+     *
+     * Numbers are in the native byte order of the machine which wrote the file.
+     *
+     * @{
+     */
+
+    static const char* magic(void) {
+        return "FSLSMPL1";
+    }
+
+    static const uint32_t version = 1;
+    static const uint32_t float64 = 1;
+
+    /**
+     * @}
+     */
+
     unsigned int rows(void) const {
-        return cells_.size();
+        return rows_;
     }
 
     unsigned int columns(void) const {
         return names_.size();
     }
 
+    bool mapped(void) const {
+        return static_cast<bool>(region_);
+    }
+
     bool has(const std::string& name) const {
         auto iter = std::find(names_.begin(),names_.end(),name);
         if(iter != names_.end()) return true;
         else return false;
     }
 
+    /**
+     * Get a pointer to the contiguous values of a column
+     */
+    const double* column(unsigned int column) const {
+        return region_?mapped_[column]:columns_[column].data();
+    }
+
+    /**
+     * Get a pointer to the contiguous likelihoods
+     */
+    const double* likelihoods(void) const {
+        return region_?mapped_likelihoods_:likelihoods_.data();
+    }
+
     double get(unsigned int row, unsigned int column) const {
-        return cells_[row].values[column];
+        return region_?mapped_[column][row]:columns_[column][row];
     }
 
     double get(unsigned int row, const std::string& name) const {
@@ -305,13 +523,23 @@ public:
         return names_;
     }
 
+    /**
+     * Do the columns have these names, in this order? Cheaper
+     * than comparing with `names()` because no copy is made.
+     */
+    bool named(const std::vector<std::string>& names) const {
+        return names_==names;
+    }
+
     Samples& names(const std::vector<std::string>& names){
+        owned_("names");
         names_ = names;
+        columns_.resize(names_.size(),Values(rows_,NAN));
         return *this;
     }
 
     double likelihood(unsigned int row) const {
-        return cells_[row].likelihood;
+        return region_?mapped_likelihoods_[row]:likelihoods_[row];
     }
 
     Sample operator[](unsigned int index) const {
@@ -332,7 +560,13 @@ public:
     }
 
     Samples& append(const Values& values,double likelihood=NAN){
-        cells_.push_back(Cell_(values,likelihood));
+        owned_("append");
+        if(values.size()>columns_.size()) columns_.resize(values.size(),Values(rows_,NAN));
+        for(unsigned int column=0;column<columns_.size();column++){
+            columns_[column].push_back(column<values.size()?values[column]:NAN);
+        }
+        likelihoods_.push_back(likelihood);
+        rows_++;
         return *this;
     }
 
@@ -340,67 +574,215 @@ public:
         return remove(sample.index());
     }
 
+    /**
+     * Remove a row
+     *
+     * The last row is moved into the place of the removed row, so that removal
+     * is O(columns) rather than O(columns x rows), and the order of rows is not preserved.
+     */
     Samples& remove(unsigned int index){
-        cells_.erase(cells_.begin()+index);
+        owned_("remove");
+        unsigned int last = rows_-1;
+        for(auto& column : columns_){
+            column[index] = column[last];
+            column.pop_back();
+        }
+        likelihoods_[index] = likelihoods_[last];
+        likelihoods_.pop_back();
+        rows_--;
         return *this;
     }
 
     /**
-     * Read a file of whitespace separated values
+     * Read a file of samples
+     *
+     * Binary samples files (see `write_binary()`) are memory mapped, binary
+     * stream files (see `Sink`) are read into memory and other files are read as whitespace separated values
+     * with the likelihood in the last column.
      * 
-     * @param  filename [description]
-     * @return          [description]
-     */
-    Samples& read(const std::string& filename,bool header=true){
-        std::ifstream file(filename);
-        std::string line;
-
-        boost::regex rgx("\\s+");
-        boost::sregex_token_iterator end;
-            
-        // Read in header   
-        std::getline(file, line);
-        boost::sregex_token_iterator iter(line.begin(),line.end(),rgx,-1);
-        for( ; iter != end; ++iter) names_.push_back(*iter);
-        // Remove the last name (which should be likelihood)
-        names_.pop_back();
-
-        while(true){
-            std::getline(file, line);
-            if(not file.good()) break;
-            boost::sregex_token_iterator iter(line.begin(),line.end(),rgx,-1);
-            Values values;
-            for( ; iter != end; ++iter){
-                std::string string = *iter;
-                double value;
-                if(string=="NA") value = NAN;
-                else value = boost::lexical_cast<double>(string);
-                values.push_back(value);
-            }
-            double likelihood = values.back();
-            values.pop_back();
-            cells_.push_back(Cell_(values,likelihood));
+     * @param  filename Name of file
+     * @param  header   Does the first line of a text file contain column names? If not, the
+     *                  current names (e.g. set using `names()`) are used.
+     * @param  threads  Number of threads used for parsing (see `Parse::table()`)
+     */
+    Samples& read(const std::string& filename,bool header=true,unsigned int threads=0){
+        char start[8] = {0};
+        std::ifstream probe(filename,std::ios::binary);
+        probe.read(start,8);
+        if(probe.gcount()==8 and std::memcmp(start,magic(),8)==0){
+            probe.close();
+            return map(filename);
+        }
+        if(probe.gcount()==8 and std::memcmp(start,Sink::magic(),8)==0){
+            probe.close();
+            return read_stream_(filename);
         }
+        probe.close();
 
-        file.close();
+        Parse::Table table = Parse::table(filename,header,threads);
+        std::vector<std::string> names;
+        if(header){
+            if(table.names.size()!=table.columns) throw std::runtime_error("`Samples::read` : number of names and values differ in file <"+filename+">");
+            // The last column should be likelihood
+            names = table.names;
+            names.pop_back();
+        } else {
+            names = names_;
+            if(table.rows>0 and names.size()+1!=table.columns) throw std::runtime_error("`Samples::read` : number of names (plus likelihood) and values differ in file <"+filename+">");
+        }
+
+        region_.reset();
+        mapped_.clear();
+        mapped_likelihoods_ = nullptr;
+        names_ = names;
+        rows_ = table.rows;
+        columns_.assign(names_.size(),Values(rows_));
+        likelihoods_.resize(rows_);
+        for(unsigned int row=0;row<rows_;row++){
+            const double* values = table.row(row);
+            for(unsigned int column=0;column<names_.size();column++) columns_[column][row] = values[column];
+            likelihoods_[row] = values[names_.size()];
+        }
+
+        return *this;
+    }
+
+private:
 
+    /**
+     * Read a binary stream file written by a `Sink`
+     */
+    Samples& read_stream_(const std::string& filename){
+        auto error = [&filename](const std::string& message){
+            return std::runtime_error("`Samples::read` : "+message+" in file <"+filename+">");
+        };
+        using namespace boost::interprocess;
+        file_mapping file(filename.c_str(),read_only);
+        mapped_region region(file,read_only);
+        const char* data = static_cast<const char*>(region.get_address());
+        std::size_t size = region.get_size();
+
+        std::size_t offset;
+        std::vector<std::string> names = Sink::header(data,size,offset,error);
+        if(names.size()==0) throw error("invalid header");
+        unsigned int columns = names.size();
+        // The last column should be likelihood
+        names.pop_back();
+
+        // Any partially written last row is ignored
+        unsigned int rows = (size-offset)/(columns*sizeof(double));
+        region_.reset();
+        mapped_.clear();
+        mapped_likelihoods_ = nullptr;
+        names_ = names;
+        rows_ = rows;
+        columns_.assign(names_.size(),Values(rows));
+        likelihoods_.resize(rows);
+        // Rows are not necessarily aligned so are copied rather than cast
+        Values values(columns);
+        for(unsigned int row=0;row<rows;row++){
+            std::memcpy(values.data(),data+offset+row*columns*sizeof(double),columns*sizeof(double));
+            for(unsigned int column=0;column<names_.size();column++) columns_[column][row] = values[column];
+            likelihoods_[row] = values[names_.size()];
+        }
         return *this;
     }
 
+public:
+
     void write(const std::string& filename){
         std::ofstream file(filename);
 
         for(auto name : names_) file<<name<<"\t";
         file<<"likelihood"<<std::endl;
     
-        for(auto row : cells_){
-            for(auto value : row.values) file<<value<<"\t";
-            file<<row.likelihood<<std::endl;
+        for(unsigned int row=0;row<rows_;row++){
+            for(unsigned int column=0;column<names_.size();column++) file<<get(row,column)<<"\t";
+            file<<likelihood(row)<<std::endl;
         }
 
         file.close();
     }
 
+    /**
+     * Write samples to a binary file which can be memory mapped using `map()`
+     */
+    void write_binary(const std::string& filename) const {
+        std::ofstream file(filename,std::ios::binary);
+        if(not file.good()) throw std::runtime_error("`Samples::write_binary` : could not open file <"+filename+">");
+
+        uint32_t columns = names_.size();
+        uint32_t version_ = version;
+        uint64_t rows = rows_;
+        std::string descriptors = Sink::descriptors(names_);
+        uint64_t offset = 8 + 4 + 4 + 8 + 8 + descriptors.size();
+        offset = (offset+7)/8*8;
+
+        file.write(magic(),8);
+        file.write(reinterpret_cast<const char*>(&columns),4);
+        file.write(reinterpret_cast<const char*>(&version_),4);
+        file.write(reinterpret_cast<const char*>(&rows),8);
+        file.write(reinterpret_cast<const char*>(&offset),8);
+        file.write(descriptors.data(),descriptors.size());
+        while(static_cast<uint64_t>(file.tellp())<offset) file.put(0);
+
+        for(unsigned int column=0;column<columns;column++){
+            file.write(reinterpret_cast<const char*>(this->column(column)),rows*sizeof(double));
+        }
+        file.write(reinterpret_cast<const char*>(likelihoods()),rows*sizeof(double));
+
+        if(not file.good()) throw std::runtime_error("`Samples::write_binary` : error writing file <"+filename+">");
+    }
+
+    /**
+     * Memory map a binary samples file
+     *
+     * The file is mapped read-only so opening it is independent of its size and
+     * copies of these `Samples` (and other processes mapping the same file) share the
+     * same pages.
+     */
+    Samples& map(const std::string& filename){
+        using namespace boost::interprocess;
+        file_mapping file(filename.c_str(),read_only);
+        auto region = std::make_shared<mapped_region>(file,read_only);
+
+        const char* data = static_cast<const char*>(region->get_address());
+        std::size_t size = region->get_size();
+        auto error = [&filename](const std::string& message){
+            return std::runtime_error("`Samples::map` : "+message+" in file <"+filename+">");
+        };
+
+        if(size<32 or std::memcmp(data,magic(),8)!=0) throw error("invalid header");
+        uint32_t columns;
+        uint32_t version_;
+        uint64_t rows;
+        uint64_t offset;
+        std::memcpy(&columns,data+8,4);
+        std::memcpy(&version_,data+12,4);
+        std::memcpy(&rows,data+16,8);
+        std::memcpy(&offset,data+24,8);
+        if(version_!=version) throw error("unsupported version");
+
+        std::size_t position = 32;
+        std::vector<std::string> names = Sink::descriptors(data,size,position,columns,error);
+        // Compare rows with the rows that fit, rather than the bytes needed with the
+        // available, so that a corrupt row count can not overflow the calculation
+        if(offset%8!=0 or offset<position or offset>size or rows>(size-offset)/((uint64_t(columns)+1)*sizeof(double))) throw error("invalid data size");
+
+        const double* values = reinterpret_cast<const double*>(data+offset);
+        mapped_.resize(columns);
+        for(uint32_t column=0;column<columns;column++) mapped_[column] = values + column*rows;
+        mapped_likelihoods_ = values + columns*rows;
+
+        names_ = names;
+        columns_.clear();
+        likelihoods_.clear();
+        rows_ = rows;
+        region_ = region;
+
+        return *this;
+    }
+
 };
 
 unsigned int Sample::columns(void) const {
@@ -411,6 +793,10 @@ bool Sample::has(const std::string& name) const {
     return samples_.has(name);
 }
 
+bool Sample::named(const std::vector<std::string>& names) const {
+    return samples_.named(names);
+}
+
 double Sample::get(unsigned int index) const {
     return samples_.get(row_,index);
 }
@@ -457,10 +843,12 @@ private:
 
 public:
 
+    /**
+     * Sum of the likelihoods of variates, using a batch kernel
+     * for the distribution if there is one (see `Likelihoods`)
+     */
     double likelihood(void) const {
-        double sum = 0;
-        for(auto variate : *this) sum += variate.likelihood();
-        return sum;
+        return Math::Probability::Likelihoods::Sum<Distribution>::of(*this);
     }
 
 }; // class Variables
@@ -552,6 +940,54 @@ private:
         }       
     };
 
+public:
+
+    /**
+     * Get the minimum and maximum values of variates in the `Set`
+     * (e.g. as bounds for an optimiser)
+     */
+    std::vector<double> minimums(void) {
+        Bounds_ mirror;
+        derived().reflect(mirror);
+        return mirror.minimums;
+    }
+
+    std::vector<double> maximums(void) {
+        Bounds_ mirror;
+        derived().reflect(mirror);
+        return mirror.maximums;
+    }
+
+    /**
+     * Get a transform for variates' values into unconstrained parameters (with
+     * `Transform::from()`) and back (with `Transform::to()`). Free variates that are bounded below by zero
+     * and unbounded above use the log link, all others use the identity link.
+     */
+    Links::Transform transform(void) {
+        Bounds_ mirror;
+        derived().reflect(mirror);
+        Links::Transform transform(mirror.minimums.size());
+        for(unsigned int index=0;index<mirror.minimums.size();index++){
+            if(mirror.frees[index] and mirror.minimums[index]==0 and mirror.maximums[index]==INFINITY) transform.log(index);
+        }
+        return transform;
+    }
+
+private:
+
+    struct Bounds_ : SetMirror<Bounds_> {
+        std::vector<double> minimums;
+        std::vector<double> maximums;
+        std::vector<bool> frees;
+
+        template<class Distribution>
+        void variate(Variate<Distribution>& variate, const std::string& name){
+            minimums.push_back(variate.minimum());
+            maximums.push_back(variate.maximum());
+            frees.push_back(variate.free());
+        }
+    };
+
 public:
 
     /**
@@ -560,6 +996,24 @@ public:
      * @param  sample A `Sample` to load variate values from
      */
     Derived& load(const Sample& sample){
+        // Binding columns are only valid for samples with the same columns, in the
+        // same order, as those compiled for. Otherwise fall back to reflection.
+        if(compiled_ and sample.named(compiled_names_)){
+            char* base = reinterpret_cast<char*>(&derived());
+            bool ok = true;
+            for(const Binding& binding : bindings_){
+                if(binding.column<0) continue;
+                double value = sample.get(binding.column);
+                if(not binding.accepts(value)){
+                    ok = false;
+                    break;
+                }
+                *reinterpret_cast<double*>(base+binding.offset) = value;
+            }
+            // If any value failed checks, reload using reflection so that
+            // errors are reported as usual
+            if(ok) return derived();
+        }
         LoadSample_ mirror(sample);
         derived().reflect(mirror);
         return derived();
@@ -623,6 +1077,20 @@ public:
      * @param  sample A `Sample` to load variate values from
      */
     Derived& load(const std::vector<double>& vector){
+        if(compiled_ and vector.size()>=bindings_.size()){
+            char* base = reinterpret_cast<char*>(&derived());
+            bool ok = true;
+            for(unsigned int index=0;index<bindings_.size();index++){
+                const Binding& binding = bindings_[index];
+                double value = vector[index];
+                if(not binding.within(value)){
+                    ok = false;
+                    break;
+                }
+                *reinterpret_cast<double*>(base+binding.offset) = value;
+            }
+            if(ok) return derived();
+        }
         LoadVector_ mirror(vector);
         derived().reflect(mirror);
         return derived();
@@ -648,6 +1116,149 @@ private:
         }       
     };
 
+public:
+
+    /**
+     * A binding of a variate to its location within the `Set` and to a
+     * column of `Samples`
+     */
+    struct Binding {
+        /**
+         * Name of the variate
+         */
+        std::string name;
+
+        /**
+         * Offset, in bytes, of the variate's value from the start of the `Set`.
+         * An offset, rather than a pointer, so that bindings remain valid when the
+         * `Set` is copied.
+         */
+        std::ptrdiff_t offset;
+
+        /**
+         * Bounds of the variate and whether it is fixed (in which case
+         * values are not checked against bounds)
+         */
+        double minimum;
+        double maximum;
+        bool fixed;
+
+        /**
+         * Column of the variate in samples (-1 if not present)
+         */
+        int column;
+
+        /**
+         * Does a value satisfy the checks done when loading from a vector?
+         */
+        bool within(double value) const {
+            return fixed or (std::isfinite(value) and value>=minimum and value<=maximum);
+        }
+
+        /**
+         * Does a value satisfy the checks done when loading from a sample?
+         */
+        bool accepts(double value) const {
+            return std::isfinite(value) and within(value);
+        }
+    };
+
+    /**
+     * Compile a flat table of bindings so that subsequent calls to `load()`
+     * are a loop over the table rather than a traversal of the `Set` with name lookups
+     *
+     * Bounds are those of the variates' distributions when compiled, so recompile
+     * if distribution parameters change. If a variate is not stored within the `Set`
+     * object (so that its offset would not survive a copy), no table is
+     * compiled and `load()` continues to use reflection. `load()` of a `Sample` only
+     * uses the table if the sample's columns are named exactly as `columns`.
+     *
+     * @param columns Names of the columns of samples to be loaded (e.g. `samples.names()`)
+     */
+    Derived& compile(const std::vector<std::string>& columns = {}){
+        std::map<std::string,int> lookup;
+        for(unsigned int column=0;column<columns.size();column++) lookup[columns[column]] = column;
+
+        Compile_ mirror(reinterpret_cast<char*>(&derived()),sizeof(Derived),lookup);
+        derived().reflect(mirror);
+
+        bindings_ = mirror.bindings;
+        compiled_ = mirror.contained;
+        compiled_names_ = columns;
+
+        // Structure of arrays of bounds for `restrict()`
+        unsigned int count = bindings_.size();
+        limits_.minimums.resize(count);
+        limits_.maximums.resize(count);
+        limits_.lowers.resize(count);
+        limits_.uppers.resize(count);
+        limits_.fixed.clear();
+        for(unsigned int index=0;index<count;index++){
+            const Binding& binding = bindings_[index];
+            double buffer = std::max((binding.maximum-binding.minimum)*0.0001,std::numeric_limits<double>::epsilon());
+            limits_.minimums[index] = binding.minimum;
+            limits_.maximums[index] = binding.maximum;
+            limits_.lowers[index] = binding.minimum+buffer;
+            limits_.uppers[index] = binding.maximum-buffer;
+            if(binding.fixed) limits_.fixed.push_back(index);
+        }
+        return derived();
+    }
+
+    Derived& compile(const Samples& samples){
+        return compile(samples.names());
+    }
+
+    /**
+     * Get the compiled table of bindings
+     */
+    const std::vector<Binding>& bindings(void) const {
+        return bindings_;
+    }
+
+private:
+
+    bool compiled_ = false;
+    std::vector<std::string> compiled_names_;
+    std::vector<Binding> bindings_;
+
+    struct Limits_ {
+        std::vector<double> minimums;
+        std::vector<double> maximums;
+        std::vector<double> lowers;
+        std::vector<double> uppers;
+        std::vector<unsigned int> fixed;
+    } limits_;
+
+    struct Compile_ : SetMirror<Compile_> {
+        char* base;
+        std::size_t size;
+        const std::map<std::string,int>& lookup;
+        std::vector<Binding> bindings;
+        bool contained = true;
+
+        Compile_(char* base, std::size_t size, const std::map<std::string,int>& lookup):
+            base(base),
+            size(size),
+            lookup(lookup){
+        }
+
+        template<class Distribution>
+        void variate(Variate<Distribution>& variate, const std::string& name){
+            char* pointer = reinterpret_cast<char*>(variate.pointer());
+            if(pointer<base or pointer+sizeof(double)>base+size) contained = false;
+            auto iter = lookup.find(name);
+            Binding binding;
+            binding.name = name;
+            binding.offset = pointer-base;
+            binding.minimum = variate.minimum();
+            binding.maximum = variate.maximum();
+            binding.fixed = not variate.free();
+            binding.column = iter==lookup.end()?-1:iter->second;
+            bindings.push_back(binding);
+        }
+    };
+
 
 public:
     void read(void){
@@ -921,6 +1532,25 @@ public:
      * Restrict variate values to their bounds
      */
     std::vector<double> restrict(const std::vector<double>& values){
+        if(compiled_ and values.size()==bindings_.size()){
+            // Same as `Variate::restrict()` but over whole vectors with selects
+            // rather than branches so that the loop can be vectorised
+            std::vector<double> restricted(values.size());
+            const double* minimums = limits_.minimums.data();
+            const double* maximums = limits_.maximums.data();
+            const double* lowers = limits_.lowers.data();
+            const double* uppers = limits_.uppers.data();
+            for(std::size_t index=0;index<values.size();index++){
+                double value = values[index];
+                double result = value>=maximums[index]?uppers[index]:value;
+                restricted[index] = value<=minimums[index]?lowers[index]:result;
+            }
+            const char* base = reinterpret_cast<const char*>(&derived());
+            for(unsigned int index : limits_.fixed){
+                restricted[index] = *reinterpret_cast<const double*>(base+bindings_[index].offset);
+            }
+            return restricted;
+        }
         Restrict_ restrict_(values);
         derived().reflect(restrict_);
         return restrict_.restricted;
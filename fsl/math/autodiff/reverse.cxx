@@ -0,0 +1,101 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/autodiff/reverse.hpp>
+#include <fsl/math/functions/logistic.hpp>
+#include <fsl/math/functions/power.hpp>
+#include <fsl/math/probability/normal.hpp>
+#include <fsl/population/growth/von-bert.hpp>
+#include <fsl/population/recruitment/beverton-holt.hpp>
+
+BOOST_AUTO_TEST_SUITE(autodiff)
+
+using namespace Fsl::Math::Autodiff;
+using namespace Fsl::Math::Functions;
+using namespace Fsl::Math::Probability;
+using namespace Fsl::Population;
+
+/**
+ * Central finite difference gradient for comparison
+ */
+template<class Function>
+std::vector<double> differences(Function function, const std::vector<double>& x){
+    std::vector<double> gradient(x.size());
+    for(unsigned int index=0;index<x.size();index++){
+        double h = 1e-6*std::max(std::fabs(x[index]),1.0);
+        std::vector<double> up = x;
+        up[index] += h;
+        std::vector<double> down = x;
+        down[index] -= h;
+        gradient[index] = (function(up)-function(down))/(2*h);
+    }
+    return gradient;
+}
+
+BOOST_AUTO_TEST_CASE(elementary){
+    std::vector<double> gradient;
+    double value = Fsl::Math::Autodiff::gradient([](const std::vector<Reverse>& x){
+        return x[0]*x[1] + exp(x[0])/x[1] - log(x[1]) + sqrt(x[0]) + pow(x[0],3) + pow(2.0,x[1]) + pow(x[0],x[1]);
+    },{1.5,2.5},gradient);
+
+    double a = 1.5, b = 2.5;
+    BOOST_CHECK_CLOSE(value,a*b + std::exp(a)/b - std::log(b) + std::sqrt(a) + std::pow(a,3) + std::pow(2,b) + std::pow(a,b),1e-10);
+    BOOST_CHECK_CLOSE(gradient[0],b + std::exp(a)/b + 0.5/std::sqrt(a) + 3*a*a + b*std::pow(a,b-1),1e-10);
+    BOOST_CHECK_CLOSE(gradient[1],a - std::exp(a)/(b*b) - 1/b + std::pow(2,b)*std::log(2) + std::pow(a,b)*std::log(a),1e-10);
+
+    // Tape is cleared and constants are not recorded
+    BOOST_CHECK_EQUAL(Tape::current().size(),0u);
+    Reverse constant = Reverse(2)*3 + exp(Reverse(1));
+    BOOST_CHECK(constant.constant());
+    BOOST_CHECK_EQUAL(Tape::current().size(),0u);
+}
+
+/**
+ * A small model using functions and distributions templated on scalar type
+ */
+template<typename Scalar>
+Scalar model(const std::vector<Scalar>& x){
+    BasicLogistic<Scalar> maturity;
+    maturity.inflection = x[0];
+    maturity.steepness = x[1];
+
+    Growth::BasicVonBert<Scalar> growth(x[2],x[3]);
+
+    BasicPower<Scalar> weight;
+    weight.a = 1e-5;
+    weight.b = x[4];
+
+    Recruitment::BasicBevertonHolt<Scalar> recruitment;
+    recruitment.r0 = 1e6;
+    recruitment.s0 = 1000;
+    recruitment.h = x[5];
+
+    Scalar biomass = 0;
+    for(double age=0.5;age<20;age++){
+        Scalar length = growth.value(age);
+        BasicNormal<Scalar> lengths(length,0.1*length);
+        biomass += maturity(age)*lengths.integrate(weight);
+    }
+    return recruitment(biomass);
+}
+
+BOOST_AUTO_TEST_CASE(functions){
+    std::vector<double> x = {5,2,0.2,60,3,0.8};
+
+    std::vector<double> gradient;
+    double value = Fsl::Math::Autodiff::gradient([&](const std::vector<Reverse>& x){
+        return model<Reverse>(x);
+    },x,gradient);
+    BOOST_CHECK_CLOSE(value,model<double>(x),1e-10);
+
+    auto expected = differences([&](const std::vector<double>& x){
+        return model<double>(x);
+    },x);
+    for(unsigned int index=0;index<x.size();index++){
+        BOOST_CHECK_CLOSE(gradient[index],expected[index],1e-3);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,372 @@
+/*!
+ * @file reverse.hpp
+ * @brief Reverse-mode automatic differentiation
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace Fsl {
+namespace Math {
+namespace Autodiff {
+
+/**
+ * A record of the elementary operations performed on `Reverse` variables
+ *
+ * Each operation on a variable that depends on the independent variables adds a node
+ * holding the indices of its (at most two) operands and the partial derivatives
+ * of the result with respect to them. Sweeping back through the nodes
+ * accumulates the adjoint of every node so that the full gradient of one output is
+ * obtained for a small constant multiple of the cost of calculating it.
+ *
+ * There is one tape per thread so that models can be differentiated concurrently.
+ */
+class Tape {
+public:
+
+    /**
+     * Index used for constants (values which do not depend on the independent variables
+     * and so are not recorded)
+     */
+    static const std::size_t none = std::numeric_limits<std::size_t>::max();
+
+    struct Node {
+        std::size_t parents[2];
+        double partials[2];
+    };
+
+    std::vector<Node> nodes;
+
+    /**
+     * Get the tape for the current thread
+     */
+    static Tape& current(void){
+        thread_local Tape tape;
+        return tape;
+    }
+
+    std::size_t size(void) const {
+        return nodes.size();
+    }
+
+    /**
+     * Clear the tape (e.g. before each gradient evaluation)
+     */
+    Tape& clear(void){
+        nodes.clear();
+        return *this;
+    }
+
+    /**
+     * Record a node and return its index
+     */
+    std::size_t push(std::size_t a = none, double da = 0, std::size_t b = none, double db = 0){
+        Node node;
+        node.parents[0] = a;
+        node.parents[1] = b;
+        node.partials[0] = da;
+        node.partials[1] = db;
+        nodes.push_back(node);
+        return nodes.size()-1;
+    }
+
+    /**
+     * Propagate adjoints back from an output node
+     *
+     * @param  output Index of the output node
+     * @return Adjoints of all nodes
+     */
+    std::vector<double> adjoints(std::size_t output) const {
+        std::vector<double> adjoints(nodes.size(),0);
+        if(output==none) return adjoints;
+        adjoints[output] = 1;
+        for(std::size_t index=output+1;index-->0;){
+            double adjoint = adjoints[index];
+            if(adjoint==0) continue;
+            const Node& node = nodes[index];
+            if(node.parents[0]!=none) adjoints[node.parents[0]] += adjoint*node.partials[0];
+            if(node.parents[1]!=none) adjoints[node.parents[1]] += adjoint*node.partials[1];
+        }
+        return adjoints;
+    }
+};
+
+/**
+ * A scalar which records operations on the current thread's `Tape`
+ *
+ * Use as the `Scalar` template parameter of model, function and distribution
+ * classes (e.g. `Matiri<MyModel,2,30,3,Reverse>`) and then `gradient()` to get
+ * exact derivatives. There is deliberately no implicit conversion to `double` so that
+ * code which would silently drop derivatives does not compile; use `value()`.
+ */
+class Reverse {
+private:
+
+    double value_;
+    std::size_t index_;
+
+public:
+
+    Reverse(const double& value = 0):
+        value_(value),
+        index_(Tape::none){
+    }
+
+    Reverse(const double& value, std::size_t index):
+        value_(value),
+        index_(index){
+    }
+
+    /**
+     * Create an independent variable
+     */
+    static Reverse independent(const double& value){
+        return Reverse(value,Tape::current().push());
+    }
+
+    double value(void) const {
+        return value_;
+    }
+
+    std::size_t index(void) const {
+        return index_;
+    }
+
+    bool constant(void) const {
+        return index_==Tape::none;
+    }
+
+    /**
+     * Create a result of a unary operation
+     */
+    static Reverse unary(double value, const Reverse& a, double da){
+        if(a.constant()) return Reverse(value);
+        return Reverse(value,Tape::current().push(a.index_,da));
+    }
+
+    /**
+     * Create a result of a binary operation
+     */
+    static Reverse binary(double value, const Reverse& a, double da, const Reverse& b, double db){
+        if(a.constant()){
+            if(b.constant()) return Reverse(value);
+            return Reverse(value,Tape::current().push(b.index_,db));
+        }
+        if(b.constant()) return Reverse(value,Tape::current().push(a.index_,da));
+        return Reverse(value,Tape::current().push(a.index_,da,b.index_,db));
+    }
+
+    Reverse& operator+=(const Reverse& other);
+    Reverse& operator-=(const Reverse& other);
+    Reverse& operator*=(const Reverse& other);
+    Reverse& operator/=(const Reverse& other);
+};
+
+/**
+ * Get the value of a scalar, so that code templated on the scalar
+ * type can be used with both `double` and `Reverse`
+ */
+inline double value(const double& x){
+    return x;
+}
+
+inline double value(const Reverse& x){
+    return x.value();
+}
+
+/**
+ * @name Arithmetic operators
+ * @{
+ */
+
+inline Reverse operator+(const Reverse& a){
+    return a;
+}
+
+inline Reverse operator-(const Reverse& a){
+    return Reverse::unary(-a.value(),a,-1);
+}
+
+inline Reverse operator+(const Reverse& a, const Reverse& b){
+    return Reverse::binary(a.value()+b.value(),a,1,b,1);
+}
+
+inline Reverse operator-(const Reverse& a, const Reverse& b){
+    return Reverse::binary(a.value()-b.value(),a,1,b,-1);
+}
+
+inline Reverse operator*(const Reverse& a, const Reverse& b){
+    return Reverse::binary(a.value()*b.value(),a,b.value(),b,a.value());
+}
+
+inline Reverse operator/(const Reverse& a, const Reverse& b){
+    double result = a.value()/b.value();
+    return Reverse::binary(result,a,1/b.value(),b,-result/b.value());
+}
+
+inline Reverse& Reverse::operator+=(const Reverse& other){
+    return *this = *this + other;
+}
+
+inline Reverse& Reverse::operator-=(const Reverse& other){
+    return *this = *this - other;
+}
+
+inline Reverse& Reverse::operator*=(const Reverse& other){
+    return *this = *this * other;
+}
+
+inline Reverse& Reverse::operator/=(const Reverse& other){
+    return *this = *this / other;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @name Comparison operators
+ *
+ * Comparisons use values only, so branches are taken as they would
+ * be with `double`s and the derivative is that of the branch taken.
+ *
+ * @{
+ */
+
+#define FSL_AUTODIFF_COMPARISON_(op) \
+    inline bool operator op(const Reverse& a, const Reverse& b){ return a.value() op b.value(); }
+    FSL_AUTODIFF_COMPARISON_(==)
+    FSL_AUTODIFF_COMPARISON_(!=)
+    FSL_AUTODIFF_COMPARISON_(<)
+    FSL_AUTODIFF_COMPARISON_(<=)
+    FSL_AUTODIFF_COMPARISON_(>)
+    FSL_AUTODIFF_COMPARISON_(>=)
+#undef FSL_AUTODIFF_COMPARISON_
+
+/**
+ * @}
+ */
+
+/**
+ * @name Elementary functions
+ *
+ * Found by argument dependent lookup so templated code should bring
+ * the `std` versions into scope and call these unqualified
+ * e.g. `using std::exp; return exp(x);`
+ *
+ * @{
+ */
+
+inline Reverse exp(const Reverse& x){
+    double result = std::exp(x.value());
+    return Reverse::unary(result,x,result);
+}
+
+inline Reverse log(const Reverse& x){
+    return Reverse::unary(std::log(x.value()),x,1/x.value());
+}
+
+inline Reverse sqrt(const Reverse& x){
+    double result = std::sqrt(x.value());
+    return Reverse::unary(result,x,0.5/result);
+}
+
+inline Reverse fabs(const Reverse& x){
+    return Reverse::unary(std::fabs(x.value()),x,x.value()<0?-1:1);
+}
+
+inline Reverse abs(const Reverse& x){
+    return fabs(x);
+}
+
+inline Reverse pow(const Reverse& x, const double& y){
+    double result = std::pow(x.value(),y);
+    return Reverse::unary(result,x,y==0?0:y*std::pow(x.value(),y-1));
+}
+
+inline Reverse pow(const double& x, const Reverse& y){
+    double result = std::pow(x,y.value());
+    return Reverse::unary(result,y,result*std::log(x));
+}
+
+inline Reverse pow(const Reverse& x, const Reverse& y){
+    if(y.constant()) return pow(x,y.value());
+    if(x.constant()) return pow(x.value(),y);
+    double result = std::pow(x.value(),y.value());
+    return Reverse::binary(
+        result,
+        x,y.value()==0?0:y.value()*std::pow(x.value(),y.value()-1),
+        y,x.value()>0?result*std::log(x.value()):0
+    );
+}
+
+inline Reverse min(const Reverse& a, const Reverse& b){
+    return b<a?b:a;
+}
+
+inline Reverse max(const Reverse& a, const Reverse& b){
+    return a<b?b:a;
+}
+
+inline bool isfinite(const Reverse& x){
+    return std::isfinite(x.value());
+}
+
+inline bool isnan(const Reverse& x){
+    return std::isnan(x.value());
+}
+
+/**
+ * @}
+ */
+
+inline std::ostream& operator<<(std::ostream& stream, const Reverse& x){
+    return stream<<x.value();
+}
+
+/**
+ * Calculate the value and gradient of a function
+ *
+ * The function is called with a vector of independent `Reverse` variables
+ * and should return a `Reverse` e.g.
+ *
+ *     std::vector<double> gradient;
+ *     double likelihood = Autodiff::gradient([&](const std::vector<Reverse>& x){
+ *         MyModel<Reverse> model;
+ *         model.parameters(x);
+ *         model.run();
+ *         return model.likelihood();
+ *     },values,gradient);
+ *
+ * @param function Function to differentiate
+ * @param x        Point at which to evaluate function
+ * @param gradient Vector to store gradient in
+ * @return Value of the function
+ */
+template<
+    class Function
+>
+double gradient(Function function, const std::vector<double>& x, std::vector<double>& gradient){
+    Tape& tape = Tape::current();
+    tape.clear();
+    std::vector<Reverse> independents;
+    independents.reserve(x.size());
+    for(auto value : x) independents.push_back(Reverse::independent(value));
+
+    Reverse result = function(independents);
+
+    std::vector<double> adjoints = tape.adjoints(result.index());
+    gradient.resize(x.size());
+    for(std::size_t index=0;index<x.size();index++) gradient[index] = adjoints[independents[index].index()];
+    tape.clear();
+    return result.value();
+}
+
+} // namespace Autodiff
+} // namespace Math
+} // namespace Fsl
@@ -26,7 +26,14 @@ public:
 		return *this;
 	}
 
-    double value(const double& x){
+    /**
+     * Get the value of the function (which is the same for all `x`)
+     *
+     * Defined as a call operator, rather than as `value(x)` which would
+     * clash with the setter above.
+     */
+    template<typename Scalar>
+    double operator()(const Scalar& x) const {
         return value_;
     }
 
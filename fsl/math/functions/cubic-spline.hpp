@@ -6,6 +6,7 @@
 
 #include <fsl/common.hpp>
 #include <fsl/math/functions/function.hpp>
+#include <fsl/math/functions/knots.hpp>
 
 namespace Fsl {
 namespace Math {
@@ -14,7 +15,7 @@ namespace Functions {
 /**
  * Cubic spline interpolation class from http://shiftedbits.org/2011/01/30/cubic-spline-interpolation/
  *
- * Modified slightly to add particular interfaces. Implementation not changed.
+ * Modified slightly to add particular interfaces and to store coefficients as arrays.
  */
 
 /* "THE BEER-WARE LICENSE" (Revision 42): Devin Lane wrote this file. As long as you retain 
@@ -22,8 +23,12 @@ namespace Functions {
  * think this stuff is worth it, you can buy me a beer in return. */
 
 /** Templated on type of X, Y. X and Y must have operator +, -, *, /. Y must have defined
- * a constructor that takes a scalar. */
-template <typename X, typename Y>
+ * a constructor that takes a scalar.
+ *
+ * Coefficients are stored as separate arrays (rather than an array of `Element`s) and segments
+ * are located using `Knots`: directly for uniformly spaced knots, otherwise by binary search.
+ * Points outside of the knots are extrapolated using the first or last segment. */
+template <typename X = double, typename Y = double>
 class CubicSpline {
 public:
     CubicSpline(void) {}
@@ -32,11 +37,11 @@ public:
         knots(x,y);
     }
 
-    virtual ~Spline(void) {}
+    virtual ~CubicSpline(void) {}
     
-    Spline& knots(const std::vector<X>& x, const std::vector<Y>& y) {
-        assert(x.size() == y.size());
-        assert(x.size() >= 3);
+    CubicSpline& knots(const std::vector<X>& x, const std::vector<Y>& y) {
+        if (x.size() != y.size()) throw std::runtime_error("`CubicSpline` : number of x and y values differ");
+        if (x.size() < 3) throw std::runtime_error("`CubicSpline` : at least three knots are required");
         
         typedef typename std::vector<X>::difference_type size_type;
         
@@ -67,9 +72,11 @@ public:
             d[j] = (c[j+1] - c[j]) / Y(3 * h[j]);
         }
         
-        for (size_type i = 0; i < n; i++) {
-            mElements.push_back(Element(x[i], y[i], b[i], c[i], d[i]));
-        }  
+        knots_.set(x);
+        as_.assign(y.begin(), y.end() - 1);
+        bs_ = b;
+        cs_.assign(c.begin(), c.end() - 1);
+        ds_ = d;
 
         return *this;      
     }
@@ -78,16 +85,9 @@ public:
         return interpolate(x);
     }
     
-    Y interpolate(const X&x) const {
-        if (mElements.size() == 0) return Y();
-        
-        typename std::vector<element_type>::const_iterator it;
-        it = std::lower_bound(mElements.begin(), mElements.end(), element_type(x));
-        if (it != mElements.begin()) {
-            it--;
-        }   
-            
-        return it->eval(x);
+    Y interpolate(const X& x) const {
+        if (as_.size() == 0) return Y();
+        return eval_(knots_.locate(x), x);
     }
     
     std::vector<Y> operator[](const std::vector<X>& xx) const {
@@ -96,52 +96,36 @@ public:
     
     /* Evaluate at multiple locations, assuming xx is sorted ascending */
     std::vector<Y> interpolate(const std::vector<X>& xx) const {
-        if (mElements.size() == 0) return std::vector<Y>(xx.size());
-        
-        typename std::vector<X>::const_iterator it;
-        typename std::vector<element_type>::const_iterator it2;
-        it2 = mElements.begin();
-        std::vector<Y> ys;
-        for (it = xx.begin(); it != xx.end(); it++) {
-            it2 = std::lower_bound(it2, mElements.end(), element_type(*it));
-            if (it2 != mElements.begin()) {
-                it2--;
-            }
-                
-            ys.push_back(it2->eval(*it));
-        }
-
+        std::vector<Y> ys(xx.size());
+        interpolate(xx.data(), ys.data(), xx.size());
         return ys;
     }
 
-protected:
-    
-    class Element {
-    public:
-        Element(X _x) : x(_x) {}
-        Element(X _x, Y _a, Y _b, Y _c, Y _d)
-        : x(_x), a(_a), b(_b), c(_c), d(_d) {}
-        
-        Y eval(const X& xx) const {
-            X xix(xx - x);
-            return a + b * xix + c * (xix * xix) + d * (xix * xix * xix);
+    /* Evaluate at `size` locations, assuming x is sorted ascending */
+    void interpolate(const X* x, Y* y, std::size_t size) const {
+        if (size == 0) return;
+        if (as_.size() == 0) {
+            for (std::size_t i = 0; i < size; i++) y[i] = Y();
+            return;
         }
-        
-        bool operator<(const Element& e) const {
-            return x < e.x;
+        std::size_t segment = knots_.locate(x[0]);
+        for (std::size_t i = 0; i < size; i++) {
+            segment = knots_.locate(x[i], segment);
+            y[i] = eval_(segment, x[i]);
         }
-        bool operator<(const X& xx) const {
-            return x < xx;
-        }
-        
-        X x;
-        Y a, b, c, d;
-    };
-            
-    typedef Element element_type;
-    std::vector<element_type> mElements;
+    }
+
+protected:
+
+    Y eval_(std::size_t segment, const X& xx) const {
+        X xix(xx - knots_.xs()[segment]);
+        return as_[segment] + xix * (bs_[segment] + xix * (cs_[segment] + xix * ds_[segment]));
+    }
+    
+    Knots<X> knots_;
+    std::vector<Y> as_, bs_, cs_, ds_;
 
-}; // class Spline
+}; // class CubicSpline
 
 } // namespace Functions
 } // namespace Math
@@ -3,33 +3,63 @@
 #include <fsl/common.hpp>
 
 #include <fsl/math/functions/function.hpp>
+#include <fsl/math/kernels/transcendental.hpp>
 
 namespace Fsl {
 namespace Math {
 namespace Functions {
 
 //! Double-logistic function
-class DoubleLogistic : public Function<DoubleLogistic> {
+template<
+    typename Scalar = double
+>
+class BasicDoubleLogistic : public Function<BasicDoubleLogistic<Scalar>> {
 public:
 
-    double inflection_1;
-    double inflection_2_delta;
-    double steepness_1;
-    double steepness_2;
+    Scalar inflection_1;
+    Scalar inflection_2_delta;
+    Scalar steepness_1;
+    Scalar steepness_2;
 
-    double value(const double& x) const {
-        double a = 1.0/(1.0+std::pow(19,(inflection_1-x)/steepness_1));
-        double b = 1.0/(1.0+std::pow(19,(x-(inflection_1+inflection_2_delta))/steepness_2));
-        double c = 1.0/(1.0+std::pow(19,
+    Scalar value(const Scalar& x) const {
+        using std::pow;
+        Scalar a = 1.0/(1.0+pow(19.0,(inflection_1-x)/steepness_1));
+        Scalar b = 1.0/(1.0+pow(19.0,(x-(inflection_1+inflection_2_delta))/steepness_2));
+        Scalar c = 1.0/(1.0+pow(19.0,
             inflection_1-(
                 (inflection_1*steepness_2+(inflection_1+inflection_2_delta)*steepness_1)/
                 (steepness_1+steepness_2)
             )/steepness_1
         ));
-        return std::min(a,b)/c;
+        return (b<a?b:a)/c;
     }
 
-}; // end class DoubleLogistic
+    /**
+     * Values at a number of points (for `double` parameters)
+     */
+    void value(const double* x, double* y, std::size_t size) const {
+        // pow(19,z) == exp(z*log(19))
+        const double log19 = 2.9444389791664403;
+        const double inflection_2 = inflection_1+inflection_2_delta;
+        const double scale_1 = log19/steepness_1;
+        const double scale_2 = log19/steepness_2;
+        const double c = 1.0/(1.0+Kernels::exp(log19*(
+            inflection_1-(
+                (inflection_1*steepness_2+inflection_2*steepness_1)/
+                (steepness_1+steepness_2)
+            )/steepness_1
+        )));
+        const double inflection = inflection_1;
+        for(std::size_t index=0;index<size;index++){
+            double a = 1.0/(1.0+Kernels::exp((inflection-x[index])*scale_1));
+            double b = 1.0/(1.0+Kernels::exp((x[index]-inflection_2)*scale_2));
+            y[index] = (b<a?b:a)/c;
+        }
+    }
+
+}; // end class BasicDoubleLogistic
+
+typedef BasicDoubleLogistic<> DoubleLogistic;
 
 } // end namespace Fsl
 } // end namespace Math
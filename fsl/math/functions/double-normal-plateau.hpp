@@ -3,18 +3,22 @@
 #include <fsl/common.hpp>
 
 #include <fsl/math/functions/function.hpp>
+#include <fsl/math/kernels/transcendental.hpp>
 
 namespace Fsl {
 namespace Math {
 namespace Functions {
 
-class DoubleNormalPlateau : public Function<DoubleNormalPlateau> {
+template<
+    typename Scalar = double
+>
+class BasicDoubleNormalPlateau : public Function<BasicDoubleNormalPlateau<Scalar>> {
 public:
 
-    double inflection_1;
-    double inflection_2_delta;
-    double steepness_1;
-    double steepness_2;
+    Scalar inflection_1;
+    Scalar inflection_2_delta;
+    Scalar steepness_1;
+    Scalar steepness_2;
 
     template<class Mirror>
     void reflect(Mirror& mirror){
@@ -26,13 +30,31 @@ public:
         ;
     }
 
-    double value(const double& x) const {
-        if(x<=inflection_1) return std::pow(2,-std::pow((x-inflection_1)/steepness_1,2));
-        else if(x>inflection_1+inflection_2_delta) return std::pow(2,-std::pow((x-(inflection_1+inflection_2_delta))/steepness_2,2));
+    Scalar value(const Scalar& x) const {
+        using std::pow;
+        if(x<=inflection_1) return pow(2.0,-pow((x-inflection_1)/steepness_1,2.0));
+        else if(x>inflection_1+inflection_2_delta) return pow(2.0,-pow((x-(inflection_1+inflection_2_delta))/steepness_2,2.0));
         else return 1;
     }
 
-}; // end class DoubleNormalPlateau
+    /**
+     * Values at a number of points (for `double` parameters)
+     */
+    void value(const double* x, double* y, std::size_t size) const {
+        // pow(2,-z^2) == exp(-z^2*log(2)); z is zero on the plateau
+        const double inflection_2 = inflection_1+inflection_2_delta;
+        const double scale_1 = 1/steepness_1;
+        const double scale_2 = 1/steepness_2;
+        const double inflection = inflection_1;
+        for(std::size_t index=0;index<size;index++){
+            double z = x[index]<=inflection?(x[index]-inflection)*scale_1:(x[index]>inflection_2?(x[index]-inflection_2)*scale_2:0);
+            y[index] = Kernels::exp(-0.69314718055994531*z*z);
+        }
+    }
+
+}; // end class BasicDoubleNormalPlateau
+
+typedef BasicDoubleNormalPlateau<> DoubleNormalPlateau;
 
 } // end namespace Fsl
 } // end namespace Math
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <utility>
+
 #include <fsl/common.hpp>
 
 namespace Fsl {
@@ -24,18 +27,39 @@ public:
      * @param  x Point at which function is evaluated
      * @return   Value of function
      */
-    double value(const double& x){
+    double value(const double& x) const {
         return 0;
     }
 
+    /**
+     * Get the values of the function at a number of points
+     *
+     * Functions which are called in hot loops override this with versions which
+     * use vectorisable kernels (see `Kernels`). Derived classes which do not override this
+     * need a `using Function<Derived>::value` declaration for it to be visible, and a
+     * `const` scalar `value()`.
+     *
+     * @param x    Points at which function is evaluated
+     * @param y    Values of function
+     * @param size Number of points
+     */
+    void value(const double* x, double* y, std::size_t size) const {
+        const Derived& self = static_cast<const Derived&>(*this);
+        for(std::size_t index=0;index<size;index++) y[index] = self.value(x[index]);
+    }
+
     /**
      * Overloading of `()` operator.
      * 
      * This is used for some functions that can accept either
      * a normal function or a `Function` instance. e.g. `Distribution::integrate()`
+     *
+     * Templated on the type of `x` so that functions with a `Scalar`
+     * template parameter can be called with automatic differentiation types.
      */
-    double operator()(const double& x){
-        return static_cast<Derived&>(*this).value(x);
+    template<typename Scalar, class Self = Derived>
+    auto operator()(const Scalar& x) -> decltype(std::declval<Self&>().value(x)) {
+        return static_cast<Self&>(*this).value(x);
     }
 };
 
@@ -0,0 +1,108 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <iomanip>
+
+#include <fsl/math/functions/logistic.hpp>
+#include <fsl/math/functions/double-logistic.hpp>
+#include <fsl/math/functions/double-normal-plateau.hpp>
+#include <fsl/math/functions/power.hpp>
+#include <fsl/math/functions/line.hpp>
+#include <fsl/math/functions/threshold.hpp>
+#include <fsl/population/growth/von-bert.hpp>
+
+BOOST_AUTO_TEST_SUITE(functions)
+
+using namespace Fsl::Math::Functions;
+using Fsl::Population::Growth::VonBert;
+
+/**
+ * Check that values at a number of points are the same as those from
+ * the scalar `value()`
+ *
+ * Batch versions use `Kernels::exp(z*log(b))` in place of `pow(b,z)` so are not
+ * identical: the difference is allowed to be a few rounding errors in `z*log(b)`
+ * (i.e. relative to the size of the exponent) and values which underflow are compared absolutely.
+ */
+template<class Function>
+void check(const Function& function, double from, double to, double tolerance = 1e-13){
+    std::vector<double> x;
+    for(double value=from;value<=to;value+=(to-from)/997) x.push_back(value);
+    std::vector<double> y(x.size());
+    function.value(x.data(),y.data(),x.size());
+    for(std::size_t index=0;index<x.size();index++){
+        double expected = function.value(x[index]);
+        double allowed = tolerance*std::max(std::fabs(expected),1e-300)*std::max(1.0,std::fabs(std::log(std::fabs(expected))));
+        if(not(std::fabs(y[index]-expected)<=allowed+1e-300)){
+            BOOST_ERROR(std::setprecision(17)<<"at x = "<<x[index]<<" batch value "<<y[index]<<" differs from scalar value "<<expected);
+            return;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(logistic){
+    Logistic logistic;
+    logistic.inflection = 5;
+    logistic.steepness = 2;
+    check(logistic,-20,40);
+}
+
+BOOST_AUTO_TEST_CASE(double_logistic){
+    DoubleLogistic function;
+    function.inflection_1 = 4;
+    function.inflection_2_delta = 6;
+    function.steepness_1 = 1.5;
+    function.steepness_2 = 3;
+    check(function,-10,40);
+}
+
+BOOST_AUTO_TEST_CASE(double_normal_plateau){
+    DoubleNormalPlateau function;
+    function.inflection_1 = 4;
+    function.inflection_2_delta = 6;
+    function.steepness_1 = 1.5;
+    function.steepness_2 = 3;
+    check(function,-10,40);
+
+    // No plateau
+    function.inflection_2_delta = 0;
+    check(function,-10,40);
+}
+
+BOOST_AUTO_TEST_CASE(power){
+    Power power;
+    power.a = 0.01;
+    power.b = 3.1;
+    check(power,0.1,100);
+}
+
+BOOST_AUTO_TEST_CASE(von_bert){
+    VonBert growth(0.3,120,-0.5);
+    check(growth,0,40);
+}
+
+BOOST_AUTO_TEST_CASE(base){
+    // Functions without a batch override use the base class version
+    // (which is const like the overrides)
+    Line line;
+    line.a = 1;
+    line.b = 2;
+    const Line& constant = line;
+    double x[] = {0,1,2.5};
+    double y[3];
+    constant.value(x,y,3);
+    BOOST_CHECK_EQUAL(y[0],1);
+    BOOST_CHECK_EQUAL(y[1],3);
+    BOOST_CHECK_EQUAL(y[2],6);
+
+    Threshold threshold;
+    threshold.inflection(1);
+    threshold.value(x,y,3);
+    BOOST_CHECK_EQUAL(y[0],0);
+    BOOST_CHECK_EQUAL(y[1],1);
+    BOOST_CHECK_EQUAL(y[2],1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
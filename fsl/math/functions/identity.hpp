@@ -9,6 +9,8 @@ namespace Functions {
     
 class Identity : public Function<Identity> {
 public:
+
+    using Function<Identity>::value;
     
     double value(const double& x) const {
         return x;
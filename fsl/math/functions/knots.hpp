@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace Fsl {
+namespace Math {
+namespace Functions {
+
+/**
+ * Knots of a spline and lookup of the segment containing a point
+ *
+ * If the knots are uniformly spaced (e.g. years or ages) the segment is calculated directly
+ * from the point, otherwise it is found by binary search. For ascending sequences of points
+ * (e.g. the times of a projection) `locate(x, segment)` walks forward from the segment of the
+ * previous point, so that a whole sequence is located in time proportional to its length.
+ *
+ * Points outside of the knots are located in the first or last segment.
+ */
+template<
+    typename X = double
+>
+class Knots {
+public:
+
+    Knots(void){
+    }
+
+    Knots(const std::vector<X>& xs){
+        set(xs);
+    }
+
+    Knots& set(const std::vector<X>& xs){
+        if(xs.size()<2) throw std::runtime_error("`Knots` : at least two knots are required");
+        for(std::size_t index=1;index<xs.size();index++){
+            if(not (xs[index]>xs[index-1])) throw std::runtime_error("`Knots` : knots must be strictly ascending");
+        }
+        xs_ = xs;
+        step_ = (xs.back()-xs.front())/X(xs.size()-1);
+        uniform_ = true;
+        for(std::size_t index=1;index<xs.size() and uniform_;index++){
+            X expected = xs.front()+step_*X(index);
+            uniform_ = std::fabs(xs[index]-expected)<=1e-12*std::fabs(step_)*X(xs.size());
+        }
+        return *this;
+    }
+
+    const std::vector<X>& xs(void) const {
+        return xs_;
+    }
+
+    std::size_t size(void) const {
+        return xs_.size();
+    }
+
+    std::size_t segments(void) const {
+        return xs_.size()-1;
+    }
+
+    bool uniform(void) const {
+        return uniform_;
+    }
+
+    bool contains(const X& x) const {
+        return x>=xs_.front() and x<=xs_.back();
+    }
+
+    /**
+     * Index of the segment containing `x`
+     */
+    std::size_t locate(const X& x) const {
+        const std::size_t last = xs_.size()-2;
+        if(not (x>xs_.front())) return 0;
+        if(not (x<xs_.back())) return last;
+        std::size_t segment;
+        if(uniform_){
+            segment = std::min(static_cast<std::size_t>((x-xs_.front())/step_),last);
+            // Correct for rounding error in the division
+            if(x<xs_[segment]) segment--;
+            else if(segment<last and x>=xs_[segment+1]) segment++;
+        } else {
+            segment = std::upper_bound(xs_.begin(),xs_.end(),x)-xs_.begin()-1;
+        }
+        return segment;
+    }
+
+    /**
+     * Index of the segment containing `x`, given the segment of a previous,
+     * smaller or equal, point
+     */
+    std::size_t locate(const X& x, std::size_t segment) const {
+        const std::size_t last = xs_.size()-2;
+        while(segment<last and x>=xs_[segment+1]) segment++;
+        return segment;
+    }
+
+private:
+
+    std::vector<X> xs_;
+    X step_ = 0;
+    bool uniform_ = false;
+};
+
+} // namespace Functions
+} // namespace Math
+} // namespace Fsl
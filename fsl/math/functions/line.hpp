@@ -12,10 +12,12 @@ namespace Functions {
 class Line : public Function<Line> {
 public:
 
+    using Function<Line>::value;
+
     double a;
     double b;
 
-    double value(const double& x){
+    double value(const double& x) const {
         return a+x*b;
     }
 
@@ -2,6 +2,7 @@
 
 #include <fsl/common.hpp>
 #include <fsl/math/functions/function.hpp>
+#include <fsl/math/kernels/transcendental.hpp>
 
 namespace Fsl {
 namespace Math {
@@ -10,20 +11,25 @@ namespace Functions {
 /**
  * Logistic function parameterised with inflection and
  * steepness parameters
+ *
+ * @tparam Scalar Type of parameters and values (e.g. `double` or an automatic differentiation type)
  */ 
-class Logistic : public Function<Logistic> {
+template<
+    typename Scalar = double
+>
+class BasicLogistic : public Function<BasicLogistic<Scalar>> {
 public:
     
     /**
      * Value of x at which y==0.50
      */
-    double inflection;
+    Scalar inflection;
 
     /**
      * Difference between the value of x where y==0.95 and
      * inflection point
      */
-    double steepness;
+    Scalar steepness;
 
     template<class Mirror>
     void reflect(Mirror& mirror){
@@ -33,11 +39,26 @@ public:
         ;
     }
 
-    double value(const double& x) const {
-        return 1.0/(1.0+std::pow(19,(inflection-x)/steepness));
+    Scalar value(const Scalar& x) const {
+        using std::pow;
+        return 1.0/(1.0+pow(19.0,(inflection-x)/steepness));
     }
 
-}; // end class Logistic
+    /**
+     * Values at a number of points (for `double` parameters)
+     */
+    void value(const double* x, double* y, std::size_t size) const {
+        // pow(19,z) == exp(z*log(19))
+        const double scale = 2.9444389791664403/steepness;
+        const double inflection_ = inflection;
+        for(std::size_t index=0;index<size;index++){
+            y[index] = 1.0/(1.0+Kernels::exp((inflection_-x[index])*scale));
+        }
+    }
+
+}; // end class BasicLogistic
+
+typedef BasicLogistic<> Logistic;
 
 } // end namespace Fsl
 } // end namespace Math
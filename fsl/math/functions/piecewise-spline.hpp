@@ -6,27 +6,92 @@
 
 #include <fsl/common.hpp>
 #include <fsl/math/functions/function.hpp>
+#include <fsl/math/functions/knots.hpp>
 
 namespace Fsl {
 namespace Math {
 namespace Functions {
 
+/**
+ * Piecewise linear interpolation between knots
+ *
+ * Segments are located using `Knots` (directly for uniformly spaced knots, otherwise
+ * by binary search) and the slope of each segment is calculated once. So that these stay
+ * consistent with the knots, `xs` and `ys` can only be changed using `knots()` or `ys()`.
+ */
 class PiecewiseSpline {
 public:
 
-    std::vector<double> xs;
-    std::vector<double> ys;
+    PiecewiseSpline(const std::vector<double>& xs, const std::vector<double>& ys){
+        knots(xs,ys);
+    }
+
+    /**
+     * Set the knots
+     */
+    PiecewiseSpline& knots(const std::vector<double>& xs, const std::vector<double>& ys){
+        if(xs.size()!=ys.size()) throw std::runtime_error("Number of x and y values differ");
+        knots_.set(xs);
+        ys_ = ys;
+        update_();
+        return *this;
+    }
+
+    const std::vector<double>& xs(void) const {
+        return knots_.xs();
+    }
+
+    const std::vector<double>& ys(void) const {
+        return ys_;
+    }
 
-    PiecewiseSpline(const std::vector<double>& xs, const std::vector<double>& ys):
-        xs(xs),ys(ys){}
+    /**
+     * Set the y values of the knots (e.g. when they are estimated) keeping the x values
+     */
+    PiecewiseSpline& ys(const std::vector<double>& ys){
+        if(ys.size()!=ys_.size()) throw std::runtime_error("Number of x and y values differ");
+        ys_ = ys;
+        update_();
+        return *this;
+    }
 
     double interpolate(const double& x) const {
-        for(unsigned int index=0;index<xs.size()-1;index++){
-            if(xs[index]<=x and x<xs[index+1]){
-                return ys[index] + (x-xs[index]) * (ys[index+1]-ys[index])/(xs[index+1]-xs[index]);
-            }
+        if(not knots_.contains(x)) throw std::runtime_error("Attempting to interpolate outside of range of x values");
+        std::size_t segment = knots_.locate(x);
+        return ys_[segment] + (x-knots_.xs()[segment]) * slopes_[segment];
+    }
+
+    /**
+     * Interpolate at a number of points which are in ascending order
+     */
+    void interpolate(const double* x, double* y, std::size_t size) const {
+        if(size==0) return;
+        if(not (knots_.contains(x[0]) and knots_.contains(x[size-1]))) {
+            throw std::runtime_error("Attempting to interpolate outside of range of x values");
+        }
+        const std::vector<double>& xs = knots_.xs();
+        std::size_t segment = knots_.locate(x[0]);
+        for(std::size_t index=0;index<size;index++){
+            segment = knots_.locate(x[index],segment);
+            y[index] = ys_[segment] + (x[index]-xs[segment]) * slopes_[segment];
+        }
+    }
+
+private:
+
+    Knots<double> knots_;
+    std::vector<double> ys_;
+    std::vector<double> slopes_;
+
+    /**
+     * Calculate the slope of each segment
+     */
+    void update_(void){
+        const std::vector<double>& xs = knots_.xs();
+        slopes_.resize(xs.size()-1);
+        for(unsigned int index=0;index<slopes_.size();index++){
+            slopes_[index] = (ys_[index+1]-ys_[index])/(xs[index+1]-xs[index]);
         }
-        throw std::runtime_error("Attempting to interpolate outside of range of x values");
     }
 
 }; // class PiecewiseSpline
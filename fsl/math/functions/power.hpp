@@ -11,18 +11,23 @@ namespace Functions {
     
 /**
  * Power function
+ *
+ * @tparam Scalar Type of parameters and values (e.g. `double` or an automatic differentiation type)
  */
-class Power : public Function<Power> {
+template<
+    typename Scalar = double
+>
+class BasicPower : public Function<BasicPower<Scalar>> {
 public:
     /**
      * Value of function when x==1
      */
-    double a;
+    Scalar a;
 
     /**
      * Exponent of power function
      */
-    double b;
+    Scalar b;
 
     template<class Mirror>
     void reflect(Mirror& mirror){
@@ -32,12 +37,27 @@ public:
         ;
     }
 
-    double value(const double& x) const {
-        return a*std::pow(x,b);
+    Scalar value(const Scalar& x) const {
+        using std::pow;
+        return a*pow(x,b);
     }
 
+    /**
+     * Values at a number of points (for `double` parameters)
+     *
+     * Uses `std::pow` rather than `Kernels::pow` which, because of the division in
+     * `Kernels::log`, is only faster when compiled for AVX or better.
+     */
+    void value(const double* x, double* y, std::size_t size) const {
+        const double a_ = a;
+        const double b_ = b;
+        for(std::size_t index=0;index<size;index++) y[index] = a_*std::pow(x[index],b_);
+    }
+
+
+}; // end class BasicPower
 
-}; // end class Power
+typedef BasicPower<> Power;
 
 } // end namespace Fsl
 } // end namespace Math
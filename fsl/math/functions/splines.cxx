@@ -0,0 +1,80 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/functions/piecewise-spline.hpp>
+#include <fsl/math/functions/cubic-spline.hpp>
+
+BOOST_AUTO_TEST_SUITE(splines)
+
+using namespace Fsl::Math::Functions;
+
+BOOST_AUTO_TEST_CASE(knots){
+    Knots<> uniform({1990,1991,1992,1993});
+    BOOST_CHECK(uniform.uniform());
+    BOOST_CHECK_EQUAL(uniform.locate(1989),0u);
+    BOOST_CHECK_EQUAL(uniform.locate(1991),1u);
+    BOOST_CHECK_EQUAL(uniform.locate(1992.5),2u);
+    BOOST_CHECK_EQUAL(uniform.locate(1993),2u);
+
+    Knots<> irregular({0,1,5,6});
+    BOOST_CHECK(not irregular.uniform());
+    BOOST_CHECK_EQUAL(irregular.locate(0.5),0u);
+    BOOST_CHECK_EQUAL(irregular.locate(5),2u);
+    BOOST_CHECK_EQUAL(irregular.locate(4,0),1u);
+
+    BOOST_CHECK_THROW(Knots<>({0,2,1}),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(piecewise){
+    PiecewiseSpline spline({0,1,3},{0,2,3});
+    BOOST_CHECK_CLOSE(spline.interpolate(0.5),1,1e-10);
+    BOOST_CHECK_CLOSE(spline.interpolate(2),2.5,1e-10);
+    BOOST_CHECK_CLOSE(spline.interpolate(3),3,1e-10);
+    BOOST_CHECK_THROW(spline.interpolate(3.1),std::runtime_error);
+
+    double x[] = {0,0.5,1,2,3};
+    double y[5];
+    spline.interpolate(x,y,5);
+    for(int index=0;index<5;index++) BOOST_CHECK_CLOSE(y[index],spline.interpolate(x[index]),1e-10);
+
+    // Changes to knots update the cached slopes
+    spline.ys({1,1,5});
+    BOOST_CHECK(spline.ys()==std::vector<double>({1,1,5}));
+    BOOST_CHECK_CLOSE(spline.interpolate(0.5),1,1e-10);
+    BOOST_CHECK_CLOSE(spline.interpolate(2),3,1e-10);
+    BOOST_CHECK_THROW(spline.ys({1,2}),std::runtime_error);
+
+    spline.knots({0,2,4,6},{0,1,2,3});
+    BOOST_CHECK(spline.xs()==std::vector<double>({0,2,4,6}));
+    BOOST_CHECK_CLOSE(spline.interpolate(5),2.5,1e-10);
+    spline.interpolate(x,y,5);
+    for(int index=0;index<5;index++) BOOST_CHECK_SMALL(y[index]-x[index]/2,1e-12);
+    BOOST_CHECK_THROW(spline.knots({0,1},{0,1,2}),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(cubic){
+    // Natural cubic spline passes through knots and is exact for lines
+    std::vector<double> xs = {0,1,2,4,8};
+    std::vector<double> ys;
+    for(double x : xs) ys.push_back(1+2*x);
+    CubicSpline<> spline(xs,ys);
+    for(double x : {0.0,0.5,3.0,7.9,8.0}) BOOST_CHECK_CLOSE(spline.interpolate(x),1+2*x,1e-10);
+
+    std::vector<double> sines;
+    std::vector<double> knots;
+    for(int index=0;index<=20;index++){
+        knots.push_back(index*0.25);
+        sines.push_back(std::sin(index*0.25));
+    }
+    CubicSpline<> sine(knots,sines);
+    std::vector<double> points = {0.1,1.3,2.2,4.9};
+    std::vector<double> values = sine.interpolate(points);
+    for(unsigned int index=0;index<points.size();index++){
+        BOOST_CHECK_SMALL(values[index]-std::sin(points[index]),5e-3);
+        BOOST_CHECK_EQUAL(values[index],sine.interpolate(points[index]));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
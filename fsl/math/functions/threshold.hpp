@@ -14,6 +14,8 @@ private:
 
 public:
 
+	using Function<Threshold>::value;
+
 	double inflection(void) const {
 		return inflection_;
 	};
@@ -23,7 +25,7 @@ public:
 		return *this;
 	};
     
-    double value(const double& x){
+    double value(const double& x) const {
         return (x<inflection_)?0:1;
     }
 }; // class Threshold
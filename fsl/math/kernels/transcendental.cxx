@@ -0,0 +1,81 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+#include <fsl/math/kernels/transcendental.hpp>
+
+BOOST_AUTO_TEST_SUITE(kernels)
+
+namespace Kernels = Fsl::Math::Kernels;
+
+/**
+ * Distance between two doubles in units in the last place
+ */
+double ulps(double a, double b){
+    if(a==b) return 0;
+    if(std::isnan(a) or std::isnan(b) or std::isinf(a) or std::isinf(b)) return INFINITY;
+    int64_t ia, ib;
+    std::memcpy(&ia,&a,sizeof(a));
+    std::memcpy(&ib,&b,sizeof(b));
+    if(ia<0) ia = INT64_MIN-ia;
+    if(ib<0) ib = INT64_MIN-ib;
+    return std::fabs(double(ia-ib));
+}
+
+BOOST_AUTO_TEST_CASE(exp){
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<double> uniform(-708,709.7);
+    double worst = 0;
+    for(int index=0;index<1000000;index++){
+        double x = uniform(engine);
+        if(index%2) x /= 100;
+        worst = std::max(worst,ulps(Kernels::exp(x),std::exp(x)));
+    }
+    BOOST_CHECK_LE(worst,1);
+
+    BOOST_CHECK_EQUAL(Kernels::exp(0),1);
+    BOOST_CHECK_EQUAL(Kernels::exp(710),INFINITY);
+    BOOST_CHECK_EQUAL(Kernels::exp(INFINITY),INFINITY);
+    BOOST_CHECK_EQUAL(Kernels::exp(-INFINITY),0);
+    BOOST_CHECK(std::isnan(Kernels::exp(NAN)));
+}
+
+BOOST_AUTO_TEST_CASE(log){
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<double> uniform(-700,700);
+    double worst = 0;
+    for(int index=0;index<1000000;index++){
+        double x = std::exp(uniform(engine));
+        if(index%2) x = 1+(x-1)/1e6;
+        worst = std::max(worst,ulps(Kernels::log(x),std::log(x)));
+    }
+    BOOST_CHECK_LE(worst,1);
+
+    BOOST_CHECK_EQUAL(Kernels::log(1),0);
+    BOOST_CHECK_EQUAL(Kernels::log(0),-INFINITY);
+    BOOST_CHECK_EQUAL(Kernels::log(INFINITY),INFINITY);
+    BOOST_CHECK_CLOSE(Kernels::log(1e-310),std::log(1e-310),1e-12);
+    BOOST_CHECK(std::isnan(Kernels::log(-1)));
+    BOOST_CHECK(std::isnan(Kernels::log(NAN)));
+}
+
+BOOST_AUTO_TEST_CASE(pow){
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<double> uniform(0,100);
+    for(int index=0;index<100000;index++){
+        double x = uniform(engine);
+        double y = uniform(engine)/10-5;
+        BOOST_REQUIRE_LE(ulps(Kernels::pow(x,y),std::pow(x,y)),1+2*std::fabs(y*std::log(x)));
+    }
+
+    // Bulk
+    double x[] = {1,2,3};
+    double y[3];
+    Kernels::pow(x,3,y,3);
+    BOOST_CHECK_CLOSE(y[2],27,1e-12);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
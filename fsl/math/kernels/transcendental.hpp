@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace Fsl {
+namespace Math {
+
+/**
+ * Fast kernels for transcendental functions
+ *
+ * Scalar versions are written without branches (special cases are handled by selecting
+ * between results) and without calls to library functions so that the loops in the bulk
+ * versions, which take arrays of arguments and results, can be vectorised by the compiler
+ * (e.g. with `-O3`). Accuracy, measured against the `std` functions in `transcendental.cxx`, is:
+ *
+ *   - `exp`: within 1 ulp. Results which would be subnormal (x < -708.39) are flushed to zero.
+ *   - `log`: within 1 ulp. Subnormal arguments are scaled so are handled correctly.
+ *   - `pow`: as `exp(y*log(x))`, so within `1 + 2*|y*log(x)|` ulp (rounding errors in `log(x)` and
+ *     `y*log(x)` are amplified by `exp`). Defined for x >= 0 only (negative `x` gives NaN).
+ *   - `exp2`: as for `pow(2,x)`.
+ */
+namespace Kernels {
+
+namespace Detail_ {
+
+inline double from_bits(uint64_t bits){
+    double value;
+    std::memcpy(&value,&bits,sizeof(value));
+    return value;
+}
+
+inline uint64_t to_bits(double value){
+    uint64_t bits;
+    std::memcpy(&bits,&value,sizeof(bits));
+    return bits;
+}
+
+// ln(2) split so that k*ln2_hi is exact for |k| < 2^11 (Cody and Waite 1980)
+static const double ln2_hi = 6.93147180369123816490e-01;
+static const double ln2_lo = 1.90821492927058770002e-10;
+static const double log2e = 1.44269504088896338700e+00;
+// Adding and subtracting rounds to the nearest integer (for |x| < 2^51)
+static const double round = 6755399441055744.0;
+
+}
+
+/**
+ * Exponential function
+ */
+inline double exp(double x){
+    using namespace Detail_;
+    // Clamp to the range of normal results; other values are selected at the end
+    double clamped = x>709.8?709.8:(x<-708.4?-708.4:x);
+    // x = k*ln(2) + r, |r| <= ln(2)/2
+    double rounded = clamped*log2e + round;
+    double k = rounded - round;
+    double r = (clamped - k*ln2_hi) - k*ln2_lo;
+    // Taylor series for exp(r) - 1 to degree 13 (truncation error < 1e-17)
+    double p = 1.0/6227020800;
+    p = p*r + 1.0/479001600;
+    p = p*r + 1.0/39916800;
+    p = p*r + 1.0/3628800;
+    p = p*r + 1.0/362880;
+    p = p*r + 1.0/40320;
+    p = p*r + 1.0/5040;
+    p = p*r + 1.0/720;
+    p = p*r + 1.0/120;
+    p = p*r + 1.0/24;
+    p = p*r + 1.0/6;
+    p = p*r + 0.5;
+    p = p*r*r + r;
+    // Multiply by 2^k in two halves so that each is a normal number (k can be 1024).
+    // Integer k is taken from the bits of `rounded`, rather than converted from `k`,
+    // and halved with a logical shift because SSE2 has neither instruction for 64 bit integers
+    int64_t ki = int64_t(to_bits(rounded) - to_bits(round));
+    int64_t k1 = int64_t(uint64_t(ki + 2048) >> 1) - 1024;
+    int64_t k2 = ki - k1;
+    double result = (1+p)*from_bits(uint64_t(k1 + 1023) << 52)*from_bits(uint64_t(k2 + 1023) << 52);
+    result = x>709.782712893384?INFINITY:result;
+    result = x<-708.39641853226408?0:result;
+    result = x==x?result:x;
+    return result;
+}
+
+/**
+ * Natural logarithm
+ */
+inline double log(double x){
+    using namespace Detail_;
+    // Scale subnormals into the normal range
+    bool subnormal = x<2.2250738585072014e-308;
+    double scaled = subnormal?x*4503599627370496.0:x;
+    uint64_t bits = to_bits(scaled);
+    // x = m * 2^e with m in [sqrt(1/2),sqrt(2))
+    int64_t e = int64_t((bits>>52) & 0x7ff) - 1023;
+    double m = from_bits((bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull);
+    bool high = m>1.4142135623730951;
+    m = high?m*0.5:m;
+    e = high?e+1:e;
+    // Convert e to a double using its bits (see `exp()`)
+    double ed = from_bits(to_bits(round) + uint64_t(e)) - round - (subnormal?52:0);
+    // log(m) = 2*atanh(s) = 2*(s + s^3/3 + s^5/5 + ...), |s| <= 0.1716
+    double s = (m-1)/(m+1);
+    double s2 = s*s;
+    double p = 2.0/23;
+    p = p*s2 + 2.0/21;
+    p = p*s2 + 2.0/19;
+    p = p*s2 + 2.0/17;
+    p = p*s2 + 2.0/15;
+    p = p*s2 + 2.0/13;
+    p = p*s2 + 2.0/11;
+    p = p*s2 + 2.0/9;
+    p = p*s2 + 2.0/7;
+    p = p*s2 + 2.0/5;
+    p = p*s2 + 2.0/3;
+    // Keep m-1 (exact) separate to reduce rounding error: 2s = (m-1) - s*(m-1)
+    double f = m-1;
+    double hfsq = s*f;
+    double result = ed*ln2_hi + ((f - hfsq) + (s*s2*p + ed*ln2_lo));
+    result = x<0?NAN:result;
+    result = x==0?-INFINITY:result;
+    result = x==INFINITY?x:result;
+    result = x==x?result:x;
+    return result;
+}
+
+/**
+ * Power function (for x >= 0)
+ */
+inline double pow(double x, double y){
+    double result = exp(y*log(x));
+    result = y==0?1:result;
+    return result;
+}
+
+/**
+ * Base 2 exponential function
+ */
+inline double exp2(double x){
+    return exp(x*0.69314718055994531);
+}
+
+/**
+ * @name Bulk kernels
+ *
+ * Calculate `size` values of the function for the arguments in `x`, putting the results in `y`
+ * (which can be the same as `x`)
+ *
+ * @{
+ */
+
+inline void exp(const double* x, double* y, std::size_t size){
+    for(std::size_t index=0;index<size;index++) y[index] = exp(x[index]);
+}
+
+inline void log(const double* x, double* y, std::size_t size){
+    for(std::size_t index=0;index<size;index++) y[index] = log(x[index]);
+}
+
+inline void pow(const double* x, double power, double* y, std::size_t size){
+    for(std::size_t index=0;index<size;index++) y[index] = pow(x[index],power);
+}
+
+/**
+ * @}
+ */
+
+} // namespace Kernels
+
+} // namespace Math
+} // namespace Fsl
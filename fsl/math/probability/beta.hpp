@@ -15,8 +15,6 @@ private:
 
 public:
 
-    using Distribution<Beta>::random;
-    
     Beta(const double& alpha = NAN, const double& beta = NAN):
         alpha_(alpha),
         beta_(beta){        
@@ -29,9 +27,37 @@ public:
         return *this;
     }
 
+    double alpha(void) const {
+        return alpha_;
+    }
+
+    double beta(void) const {
+        return beta_;
+    }
+
+    bool valid(void) const {
+        return alpha_>0 and beta_>0 and std::isfinite(alpha_) and std::isfinite(beta_);
+    }
+
     boost::math::beta_distribution<> boost_dist(void) const {
         return boost::math::beta_distribution<>(alpha_,beta_);
     }
+
+    /**
+     * Generate a random number from the ratio of gamma variates
+     * (rather than by inverting the CDF, which requires an iterative root find)
+     */
+    double random(void) const {
+        if(not valid()) return NAN;
+        return Samplers::beta(Generator,alpha_,beta_);
+    }
+
+    void random(std::size_t size, double* values) const {
+        auto& generator = Generator;
+        for(std::size_t index=0;index<size;index++){
+            values[index] = valid()?Samplers::beta(generator,alpha_,beta_):NAN;
+        }
+    }
 };
 
 }}}
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <boost/random/discrete_distribution.hpp>
+#include <array>
 
 #include <fsl/math/probability/distribution.hpp>
+#include <fsl/math/probability/uniform.hpp>
 
 namespace Fsl {
 namespace Math {
@@ -26,18 +27,19 @@ public:
     Discrete(std::array<Type,Size> levels, std::array<double,Size> densities):
         levels(levels),
         densities(densities),
-        rand_distr_(densities.begin(),densities.end()){
+        alias_(densities.data(),Size){
     }
     
+    /**
+     * Draw a level in constant time using an alias table
+     */
     Type random(void) const {
-        boost::variate_generator<boost::mt19937&,decltype(rand_distr_)> randomVariate(Generator,rand_distr_);
-        auto which = randomVariate();
-        return levels[which];
+        return levels[alias_(Generator)];
     }
 
 private:
 
-    boost::random::discrete_distribution<> rand_distr_;
+    Samplers::Alias alias_;
 };
 
 }}}
@@ -2,6 +2,8 @@
 
 //For seeding random number generator with current time
 #include <ctime>
+//For distinguishing the seeds of generators in different threads
+#include <atomic>
 
 //For random number scaffolding...
 #include <boost/random/mersenne_twister.hpp>
@@ -11,6 +13,9 @@
 //For default random number generation...
 #include <boost/random/uniform_01.hpp>
 
+#include <fsl/math/probability/samplers.hpp>
+#include <fsl/math/quadrature/gauss.hpp>
+
 #include <stencila/structure.hpp>
 using Stencila::Structure;
 
@@ -20,21 +25,28 @@ namespace Probability {
 	
 /*!
 A scaffolding object that holds the random number generator used in the random() methods
+
+There is one generator per thread so that models can be run concurrently (e.g. in
+`Estimation::Estimators::Profiler`) without data races on the generator's state.
 */
 struct Generator : boost::mt19937 {
 	Generator(void){
-		//! Set random number generator seed using current time
-		seed(static_cast<unsigned int>(std::time(0)));
+		//! Set random number generator seed using current time and, so that threads
+		//! started at the same time get different streams, a count of generators created
+		static std::atomic<unsigned int> count(0);
+		seed(static_cast<unsigned int>(std::time(0)) + 2654435761u*count++);
 	}
-} Generator;
+};
+thread_local struct Generator Generator;
 
 /*!
 A base implementation class for all probability distributions
 	
 All probability distributions have a member called data_ which is a boost::math distribution.
 (The alternative of deriving from both boost::math distributions caused a mysterious memory bug in testing).
-Random variates are produced using boost::random distributions within the random() method.
-Specific classes might overide the random() method to provide greate efficiency (?) by using the boost::random distributions directly, rather than using quantile().
+Random variates are produced by inverting the CDF within the random() method.
+Specific classes overide the random() method to provide greater efficiency by using direct samplers (see `Samplers`)
+where quantile() is not closed form.
 
 Boost::math defines a number of non-member properties that are common to all distributions:
 	'cdf','complement','chf','hazard','kurtosis','kurtosis_excess','mean','median','mode','pdf','range','quantile','skewness','standard_deviation','support','variance'
@@ -138,21 +150,13 @@ public:
 	double integrate(const double& from,const double& to,Function function,Parameters... parameters) const {
 		/*!
 		Calculate the integral of distibution times function (called with parameters).  The first argument of function is the x value of distibutuion.
-		Simpson's composite rule
+		Gauss-Legendre quadrature (see `Quadrature::Legendre`). Specific distributions may override `integrate(function)`
+		with rules for their density (e.g. precomputed density weights for `Normal`).
 		*/
-		int n = 10;
-		n = n+(n%2); //This ensures that n is even
-		double interval =  (to-from) / n;
-
-		double ans = function(from,parameters...)*pdf(from)+function(to,parameters...)*pdf(to);                                                                       
-		double x = from + interval;
-		int m = 4;
-		for(int i=1;i<n;i++){
-			ans += m*function(x,parameters...)*pdf(x);
-			m = 6-m;
-			x += interval;
-		}
-		return  interval * ans / 3;
+		static const Quadrature::Legendre<>& legendre = Quadrature::Legendre<>::instance();
+		return legendre.integrate([&](double x){
+			return function(x,parameters...)*pdf(x);
+		},from,to);
 	}
 	
 	template<
@@ -167,9 +171,15 @@ public:
 		/*!
 		A generalised means of generating a random number for a distribution. A specific distribution might override this for efficiency
 		*/
-		boost::uniform_01<> dist;
-		boost::variate_generator<boost::mt19937&, boost::uniform_01<> > randomVariate(Generator,dist);
-		return quantile(randomVariate());
+		return quantile(Samplers::uniform(Generator));
+	}
+
+	/*!
+	Fill `values` with `size` random numbers. Specific distributions override this with
+	bulk samplers.
+	*/
+	void random(std::size_t size, double* values) const {
+		for(std::size_t index=0;index<size;index++) values[index] = derived().random();
 	}
 };
 
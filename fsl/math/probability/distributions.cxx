@@ -4,10 +4,16 @@
 #include <boost/test/unit_test.hpp>
 
 #include <fsl/math/probability/beta.hpp>
+#include <fsl/math/probability/discrete.hpp>
+#include <fsl/math/probability/exponential.hpp>
 #include <fsl/math/probability/fixed.hpp>
+#include <fsl/math/probability/likelihoods.hpp>
 #include <fsl/math/probability/lognormal.hpp>
+#include <fsl/math/probability/multinomial.hpp>
 #include <fsl/math/probability/normal.hpp>
+#include <fsl/math/probability/truncated.hpp>
 #include <fsl/math/probability/uniform.hpp>
+#include <fsl/math/functions/power.hpp>
 
 BOOST_AUTO_TEST_SUITE(cached)
 
@@ -44,3 +50,233 @@ BOOST_AUTO_TEST_CASE(uniform){
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(samplers)
+
+using namespace Fsl::Math::Probability;
+
+/**
+ * Mean, variance and proportion above a threshold of random draws
+ */
+template<class Distribution>
+std::vector<double> moments(const Distribution& distribution, double threshold, unsigned int draws = 1000000){
+    double mean = 0;
+    double m2 = 0;
+    double above = 0;
+    for(unsigned int draw=1;draw<=draws;draw++){
+        double value = distribution.random();
+        double diff = value-mean;
+        mean += diff/draw;
+        m2 += diff*(value-mean);
+        if(value>threshold) above++;
+    }
+    return {mean,m2/(draws-1),above/draws};
+}
+
+BOOST_AUTO_TEST_CASE(normal){
+    auto result = moments(Normal(1,2),1+2*3.5);
+    BOOST_CHECK_SMALL(result[0]-1,0.01);
+    BOOST_CHECK_SMALL(result[1]-4,0.03);
+    // Tail (beyond the base layer of the ziggurat)
+    BOOST_CHECK_SMALL(result[2]-2.326290790355e-4,3e-5);
+}
+
+BOOST_AUTO_TEST_CASE(lognormal){
+    // As for the legacy `boost::lognormal_distribution`, parameters are the
+    // mean and sd of values (e.g. a multiplicative error with a mean of one)
+    Lognormal lognormal(1,0.2);
+    auto result = moments(lognormal,1/std::sqrt(1.04));
+    BOOST_CHECK_SMALL(result[0]-1,0.001);
+    BOOST_CHECK_SMALL(result[1]-0.04,0.0005);
+    // Median is exp(log_location())
+    BOOST_CHECK_SMALL(result[2]-0.5,0.002);
+    BOOST_CHECK_CLOSE(std::exp(lognormal.log_location()),1/std::sqrt(1.04),1e-10);
+    BOOST_CHECK_CLOSE(lognormal.log_dispersion(),std::sqrt(std::log(1.04)),1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(beta){
+    for(auto parameters : std::vector<std::vector<double>>{{2,5},{0.5,0.5},{30,10}}){
+        double a = parameters[0];
+        double b = parameters[1];
+        Beta beta(a,b);
+        auto result = moments(beta,beta.median());
+        BOOST_CHECK_SMALL(result[0]-a/(a+b),0.002);
+        BOOST_CHECK_SMALL(result[1]-a*b/((a+b)*(a+b)*(a+b+1)),0.001);
+        BOOST_CHECK_SMALL(result[2]-0.5,0.002);
+    }
+    BOOST_CHECK(std::isnan(Beta().random()));
+}
+
+BOOST_AUTO_TEST_CASE(bulk){
+    const unsigned int size = 1000000;
+    std::vector<double> values(size);
+
+    auto check = [&](double mean, double sd, double tolerance){
+        double sum = 0;
+        double sum_squares = 0;
+        for(auto value : values){
+            sum += value;
+            sum_squares += value*value;
+        }
+        BOOST_CHECK_SMALL(sum/size-mean,tolerance);
+        BOOST_CHECK_SMALL(std::sqrt(sum_squares/size-std::pow(sum/size,2))-sd,tolerance);
+    };
+
+    Normal(1,2).random(size,values.data());
+    check(1,2,0.01);
+
+    Lognormal(0.5,0.3).random(size,values.data());
+    check(0.5,0.3,0.005);
+
+    Uniform(1,3).random(size,values.data());
+    check(2,2/std::sqrt(12),0.005);
+
+    Exponential(2).random(size,values.data());
+    check(0.5,0.5,0.005);
+
+    Beta(2,5).random(size,values.data());
+    check(2.0/7,std::sqrt(10.0/(49*8)),0.002);
+}
+
+BOOST_AUTO_TEST_CASE(uniform_exponential){
+    auto uniform = moments(Uniform(1,3),2.5);
+    BOOST_CHECK_SMALL(uniform[0]-2,0.005);
+    BOOST_CHECK_SMALL(uniform[2]-0.25,0.002);
+
+    auto exponential = moments(Exponential(2),1);
+    BOOST_CHECK_SMALL(exponential[0]-0.5,0.003);
+    BOOST_CHECK_SMALL(exponential[2]-std::exp(-2),0.002);
+}
+
+BOOST_AUTO_TEST_CASE(likelihoods){
+    // Batch kernels are the same as the log of the pdf
+    double observeds[] = {0.2,0.5,0.9,NAN};
+    double firsts[] = {0.3,0.4,0.5,0.5};
+    double seconds[] = {0.1,2,0.5,0.5};
+    double normal = 0, lognormal = 0, beta = 0;
+    for(int index=0;index<3;index++){
+        normal += std::log(Normal(firsts[index],seconds[index]).pdf(observeds[index]));
+        lognormal += std::log(Lognormal(firsts[index],seconds[index]).pdf(observeds[index]));
+        beta += std::log(Beta(firsts[index],seconds[index]).pdf(observeds[index]));
+    }
+    BOOST_CHECK_CLOSE(Likelihoods::normal(observeds,firsts,seconds,4),normal,1e-10);
+    BOOST_CHECK_CLOSE(Likelihoods::lognormal(observeds,firsts,seconds,4),lognormal,1e-10);
+    BOOST_CHECK_CLOSE(Likelihoods::beta(observeds,firsts,seconds,4),beta,1e-10);
+
+    // Far into the tails, where the pdf underflows
+    double far = 100;
+    double zero = 0, one = 1;
+    BOOST_CHECK_CLOSE(Likelihoods::normal(&far,&zero,&one,1),-5000-0.5*std::log(2*M_PI),1e-10);
+
+    // Multinomial against the binomial
+    double observed[] = {0.3,0.7};
+    double expected[] = {0.4,0.6};
+    BOOST_CHECK_CLOSE(
+        Likelihoods::multinomial(observed,expected,2,10),
+        std::log(120*std::pow(0.4,3)*std::pow(0.6,7)),
+        1e-10
+    );
+}
+
+BOOST_AUTO_TEST_CASE(truncated){
+    // Far in the tails, where rejection from the untruncated distribution would never finish
+    Truncated<Normal> tail(0,1,10,INFINITY);
+    Truncated<Normal> narrow(0,1,-8.001,-8);
+    Truncated<Lognormal> lognormal(0.5,1,100,200);
+    Truncated<Beta> beta(2,5,0.95,0.99);
+    double sum = 0;
+    for(int index=0;index<10000;index++){
+        double value = tail.random();
+        BOOST_REQUIRE(value>=10);
+        sum += value;
+
+        value = narrow.random();
+        BOOST_REQUIRE(value>=-8.001 and value<=-8);
+
+        value = lognormal.random();
+        BOOST_REQUIRE(value>=100 and value<=200);
+
+        value = beta.random();
+        BOOST_REQUIRE(value>=0.95 and value<=0.99);
+    }
+    // Mean of the tail is approximately pdf(10)/(1-cdf(10))
+    BOOST_CHECK_CLOSE(sum/10000,10.0981,0.1);
+}
+
+BOOST_AUTO_TEST_CASE(alias_multinomial){
+    std::vector<double> weights = {1,0,3,6};
+    Samplers::Alias alias(weights);
+    std::vector<double> counts(4,0);
+    for(int index=0;index<100000;index++) counts[alias(Generator)]++;
+    BOOST_CHECK_EQUAL(counts[1],0);
+    BOOST_CHECK_SMALL(counts[0]/100000-0.1,0.005);
+    BOOST_CHECK_SMALL(counts[3]/100000-0.6,0.005);
+
+    Discrete<char,3> discrete({'a','b','c'},{0,1,0});
+    BOOST_CHECK_EQUAL(discrete.random(),'b');
+
+    // Both small and large sample sizes sum to the size and have the expected proportions
+    double proportions[] = {0.1,0.2,0.3,0.4};
+    for(double size : {3.0,1000.0}){
+        std::vector<double> sums(4,0);
+        for(int replicate=0;replicate<2000;replicate++){
+            double observeds[4];
+            Multinomial::random(proportions,4,size,observeds);
+            BOOST_REQUIRE_CLOSE(observeds[0]+observeds[1]+observeds[2]+observeds[3],1,1e-10);
+            for(int bin=0;bin<4;bin++) sums[bin] += observeds[bin];
+        }
+        for(int bin=0;bin<4;bin++) BOOST_CHECK_SMALL(sums[bin]/2000-proportions[bin],0.02);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(integrate)
+
+using namespace Fsl::Math::Probability;
+using Fsl::Math::Functions::Power;
+
+/**
+ * Expected value of a function over the central 99.9% of a normal using
+ * Simpson's rule with many intervals
+ */
+template<class Function>
+double reference(Function function, double mean, double sd){
+    const double z = 3.2905267314919255;
+    const int n = 20000;
+    double from = mean-z*sd;
+    double interval = 2*z*sd/n;
+    Normal normal(mean,sd);
+    double sum = 0;
+    for(int i=0;i<=n;i++){
+        double x = from+i*interval;
+        sum += (i==0 or i==n?1:(i%2?4:2))*function(x)*normal.pdf(x);
+    }
+    return sum*interval/3/0.999;
+}
+
+BOOST_AUTO_TEST_CASE(weight_length){
+    // Weight at length with a non-integer exponent is not defined for negative lengths
+    Power weight_length;
+    weight_length.a = 0.01;
+    weight_length.b = 3.1;
+    for(double cv : {0.1,0.2,0.25,0.3}){
+        Normal lengths(5,5*cv);
+        double weight = lengths.integrate(weight_length);
+        BOOST_CHECK(std::isfinite(weight));
+        BOOST_CHECK_CLOSE(weight,reference(weight_length,5,5*cv),0.01);
+    }
+
+    // Batch version gives the same values
+    std::vector<Normal> distributions = {Normal(5,0.5),Normal(10,2.5),Normal(20,6)};
+    double results[3];
+    Normal::integrals(weight_length,distributions.data(),3,results);
+    for(int index=0;index<3;index++){
+        BOOST_CHECK_CLOSE(results[index],distributions[index].integrate(weight_length),1e-10);
+    }
+
+    // Invalid distributions give NaN
+    BOOST_CHECK(std::isnan(Normal(5,0).integrate(weight_length)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
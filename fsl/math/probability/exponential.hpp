@@ -23,9 +23,11 @@ public:
     }
     
     double random(void) const {
-        boost::exponential_distribution<> distr(lambda_);
-        boost::variate_generator<boost::mt19937&,decltype(distr)> randomVariate(Generator,distr);
-        return randomVariate();
+        return Samplers::exponential(Generator,lambda_);
+    }
+
+    void random(std::size_t size, double* values) const {
+        Samplers::exponential(Generator,values,size,lambda_);
     }
 private:
     double lambda_;
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace Fsl {
+namespace Math {
+namespace Probability {
+
+template<typename Scalar> class BasicNormal;
+class Lognormal;
+class Beta;
+
+/**
+ * Batch log-likelihood kernels
+ *
+ * Each kernel takes contiguous arrays of observations and parameters and returns the
+ * sum of the log densities. Log densities are calculated in closed form, rather than as
+ * `std::log(pdf(x))`, so they do not underflow in the tails and there is no boost distribution to
+ * construct for each observation. Loops (other than for `beta()`, which calls `lgamma`) are
+ * branch free so that they can be vectorised.
+ *
+ * As for `Variate::likelihood()`, observations which are not finite, or which have invalid
+ * parameters, contribute zero. Observations outside of the support contribute `-INFINITY`.
+ */
+namespace Likelihoods {
+
+static const double log_sqrt_2pi = 0.91893853320467274;
+
+/**
+ * Normal log density
+ */
+inline double normal(const double* observeds, const double* means, const double* sds, std::size_t size){
+    double sum = 0;
+    for(std::size_t index=0;index<size;index++){
+        double x = observeds[index];
+        double sd = sds[index];
+        double z = (x-means[index])/sd;
+        double value = -0.5*z*z-std::log(sd)-log_sqrt_2pi;
+        bool ok = std::isfinite(x) and std::isfinite(means[index]) and sd>0;
+        sum += ok?value:0;
+    }
+    return sum;
+}
+
+/**
+ * Lognormal log density (`locations` and `dispersions` are the mean and
+ * standard deviation of the log of observations)
+ */
+inline double lognormal(const double* observeds, const double* locations, const double* dispersions, std::size_t size){
+    double sum = 0;
+    for(std::size_t index=0;index<size;index++){
+        double x = observeds[index];
+        double dispersion = dispersions[index];
+        double log_x = std::log(x);
+        double z = (log_x-locations[index])/dispersion;
+        double value = -0.5*z*z-log_x-std::log(dispersion)-log_sqrt_2pi;
+        bool ok = std::isfinite(x) and locations[index]>0 and dispersion>0;
+        sum += ok?(x>0?value:-INFINITY):0;
+    }
+    return sum;
+}
+
+/**
+ * Beta log density
+ */
+inline double beta(const double* observeds, const double* alphas, const double* betas, std::size_t size){
+    double sum = 0;
+    for(std::size_t index=0;index<size;index++){
+        double x = observeds[index];
+        double a = alphas[index];
+        double b = betas[index];
+        bool ok = std::isfinite(x) and a>0 and b>0 and std::isfinite(a) and std::isfinite(b);
+        if(not ok) continue;
+        if(x>0 and x<1) sum += (a-1)*std::log(x)+(b-1)*std::log1p(-x)+std::lgamma(a+b)-std::lgamma(a)-std::lgamma(b);
+        else sum += -INFINITY;
+    }
+    return sum;
+}
+
+/**
+ * Multinomial log probability of observed proportions in `bins`, given
+ * expected proportions and a sample size
+ */
+inline double multinomial(const double* observeds, const double* expecteds, std::size_t bins, double size){
+    if(not (size>0)) return 0;
+    double sum = std::lgamma(size+1);
+    for(std::size_t bin=0;bin<bins;bin++){
+        double count = observeds[bin]*size;
+        double value = count*std::log(expecteds[bin])-std::lgamma(count+1);
+        sum += count>0?value:0;
+    }
+    return sum;
+}
+
+/**
+ * Fournier et al. (1990) robust normal log-likelihood of observed proportions
+ * in `bins`, given expected proportions and a sample size (capped at 1000)
+ */
+inline double fournier(const double* observeds, const double* expecteds, std::size_t bins, double size){
+    double n = std::min(size,1000.0);
+    double a = 0;
+    double b = 0;
+    for(std::size_t bin=0;bin<bins;bin++){
+        double o = observeds[bin];
+        double e = expecteds[bin];
+        double variance = (1-e)*e+0.1/bins;
+        a += std::log(variance);
+        double diff = o-e;
+        b += std::log(std::exp(-diff*diff*n/(2*variance))+0.01);
+    }
+    return b-0.5*a;
+}
+
+/**
+ * Sum of the likelihoods of items which are both a distribution and have
+ * a `value()` (e.g. the `Variate`s in `Variables`)
+ *
+ * Specialised for distributions which have a batch kernel: values and parameters
+ * are gathered into contiguous arrays and passed to the kernel.
+ */
+template<class Distribution>
+struct Sum {
+    template<class Items>
+    static double of(const Items& items){
+        double sum = 0;
+        for(const auto& item : items) sum += item.likelihood();
+        return sum;
+    }
+};
+
+template<class Items, class Parameters>
+double gather_(const Items& items, Parameters parameters, double (*kernel)(const double*, const double*, const double*, std::size_t)){
+    std::vector<double> values, firsts, seconds;
+    for(const auto& item : items){
+        values.push_back(item.value());
+        double first, second;
+        parameters(item,first,second);
+        firsts.push_back(first);
+        seconds.push_back(second);
+    }
+    return kernel(values.data(),firsts.data(),seconds.data(),values.size());
+}
+
+template<>
+struct Sum<BasicNormal<double>> {
+    template<class Items>
+    static double of(const Items& items){
+        typedef decltype(*std::begin(items)) Item;
+        return gather_(items,[](Item item, double& mean, double& sd){
+            mean = item.mean();
+            sd = item.sd();
+        },normal);
+    }
+};
+
+template<>
+struct Sum<Lognormal> {
+    template<class Items>
+    static double of(const Items& items){
+        typedef decltype(*std::begin(items)) Item;
+        return gather_(items,[](Item item, double& location, double& dispersion){
+            location = item.location;
+            dispersion = item.dispersion;
+        },lognormal);
+    }
+};
+
+template<>
+struct Sum<Beta> {
+    template<class Items>
+    static double of(const Items& items){
+        typedef decltype(*std::begin(items)) Item;
+        return gather_(items,[](Item item, double& alpha, double& beta){
+            alpha = item.alpha();
+            beta = item.beta();
+        },beta);
+    }
+};
+
+} // namespace Likelihoods
+
+}}}
@@ -52,10 +52,51 @@ public:
         return boost::math::lognormal(location,dispersion);
     }
     
+    using Distribution<Lognormal>::integrate;
+
+    /**
+     * Calculate the integral of the distribution times a function
+     *
+     * Uses Gauss-Hermite quadrature over the log of values (see `Quadrature::Hermite`)
+     */
+    template<
+        typename Function
+    >
+    double integrate(Function function) const {
+        static const Quadrature::Hermite<>& hermite = Quadrature::Hermite<>::instance();
+        if(not valid()) return NAN;
+        return hermite.integrate([&](double x){
+            return function(std::exp(x));
+        },location,dispersion);
+    }
+
+    /**
+     * Mean of the log of random values
+     *
+     * As for the legacy `boost::lognormal_distribution`, `random()` treats `location`
+     * and `dispersion` as the mean and standard deviation of values, so they are converted
+     * to the parameters of the underlying normal distribution.
+     */
+    double log_location(void) const {
+        return std::log(location*location/std::sqrt(dispersion*dispersion+location*location));
+    }
+
+    /**
+     * Standard deviation of the log of random values (see `log_location()`)
+     */
+    double log_dispersion(void) const {
+        return std::sqrt(std::log(1+dispersion*dispersion/(location*location)));
+    }
+
     double random(void) const {
-        boost::lognormal_distribution<> distr(location,dispersion);
-        boost::variate_generator<boost::mt19937&,decltype(distr)> randomVariate(Generator,distr);
-        return randomVariate();
+        return std::exp(log_location() + log_dispersion()*Samplers::normal(Generator));
+    }
+
+    void random(std::size_t size, double* values) const {
+        const double mu = log_location();
+        const double sigma = log_dispersion();
+        Samplers::normal(Generator,values,size);
+        for(std::size_t index=0;index<size;index++) values[index] = std::exp(mu + sigma*values[index]);
     }
 
     template<class Mirror>
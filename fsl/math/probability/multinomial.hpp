@@ -45,8 +45,28 @@ public:
         return NAN;
     }
 
+    /**
+     * Generate a random observed proportion (i.e. from the marginal binomial
+     * distribution of a bin with `proportion` expected)
+     */
     double random(void) const {
-        return NAN;
+        double trials = std::floor(size);
+        if(not (trials>0)) return NAN;
+        return Samplers::binomial(Generator,trials,proportion)/trials;
+    }
+
+    /**
+     * Generate random observed proportions for `bins` with `proportions` expected
+     * and a sample size of `size`
+     */
+    static void random(const double* proportions, std::size_t bins, double size, double* observeds) {
+        double trials = std::floor(size);
+        if(not (trials>0)){
+            for(std::size_t bin=0;bin<bins;bin++) observeds[bin] = NAN;
+            return;
+        }
+        Samplers::multinomial(Generator,trials,proportions,bins,observeds);
+        for(std::size_t bin=0;bin<bins;bin++) observeds[bin] /= trials;
     }
 
     template<class Mirror>
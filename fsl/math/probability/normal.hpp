@@ -4,7 +4,10 @@
 #include <boost/random/normal_distribution.hpp>
 #include <boost/format.hpp>
 
+#include <vector>
+
 #include <fsl/math/probability/distribution.hpp>
+#include <fsl/math/autodiff/reverse.hpp>
 
 namespace Fsl {
 namespace Math {
@@ -12,46 +15,111 @@ namespace Probability {
 
 using namespace Fsl;
 
-class Normal : public Distribution<Normal> {
+/**
+ * Normal distribution
+ *
+ * @tparam Scalar Type of parameters (e.g. `double` or an automatic differentiation type).
+ *                Only `pdf()` and `integrate()` are differentiable; other methods use the
+ *                parameter values.
+ */
+template<
+    typename Scalar = double
+>
+class BasicNormal : public Distribution<BasicNormal<Scalar>> {
 private:
-    double mean_;
-    double sd_;
+    Scalar mean_;
+    Scalar sd_;
 
 public:
 
-    Normal(const double& mean = NAN, const double& sd = NAN):
+    BasicNormal(const Scalar& mean = NAN, const Scalar& sd = NAN):
         mean_(mean),
         sd_(sd){
     }
     
     bool valid(void) const {
-        return std::isfinite(mean_) and sd_>0;
+        return std::isfinite(Autodiff::value(mean_)) and sd_>0;
     }
 
-    const double& mean(void) const {
+    const Scalar& mean(void) const {
         return mean_;
     }
 
-    double& mean(void) {
+    Scalar& mean(void) {
         return mean_;
     }
 
-    const double& sd(void) const {
+    const Scalar& sd(void) const {
         return sd_;
     }
 
-    double& sd(void) {
+    Scalar& sd(void) {
         return sd_;
     }
 
     boost::math::normal boost_dist(void) const {
-        return boost::math::normal(mean(),sd());
+        return boost::math::normal(Autodiff::value(mean()),Autodiff::value(sd()));
     }
-    
+
+    Scalar pdf(const Scalar& x) const {
+        using std::exp;
+        if(not valid()) return NAN;
+        Scalar z = (x-mean_)/sd_;
+        return exp(-0.5*z*z)/(sd_*2.5066282746310002);
+    }
+
+    using Distribution<BasicNormal<Scalar>>::integrate;
+
+    /**
+     * Calculate the integral of the distribution times a function
+     *
+     * Over the same central 99.9% of the distribution as `Distribution::integrate()` but using
+     * Gauss-Legendre nodes with precomputed density weights (see `Quadrature::Central`), so there are no
+     * `pdf()` evaluations. Gauss-Hermite is not used because its outer nodes are far enough into the
+     * tails that functions defined only for positive values (e.g. weight at length) would be evaluated
+     * at negative values for moderate coefficients of variation. The nodes are calculated from `Scalar`
+     * parameters so that the result can be differentiated.
+     */
+    template<
+        typename Function
+    >
+    Scalar integrate(Function function) const {
+        static const Quadrature::Central<>& central = Quadrature::Central<>::instance();
+        if(not valid()) return NAN;
+        return central.integrate(function,mean_,sd_);
+    }
+
+    /**
+     * Calculate the integrals of a function over a number of distributions
+     *
+     * e.g. mean weight at age from the distributions of length at age
+     */
+    template<
+        typename Function
+    >
+    static void integrals(Function function, const BasicNormal* distributions, std::size_t size, double* results) {
+        static const Quadrature::Central<>& central = Quadrature::Central<>::instance();
+        std::vector<double> means(size);
+        std::vector<double> sds(size);
+        for(std::size_t index=0;index<size;index++){
+            means[index] = Autodiff::value(distributions[index].mean_);
+            sds[index] = Autodiff::value(distributions[index].sd_);
+        }
+        central.integrate(function,means.data(),sds.data(),size,results);
+        for(std::size_t index=0;index<size;index++){
+            if(not distributions[index].valid()) results[index] = NAN;
+        }
+    }
+
     double random(void) const {
-        boost::normal_distribution<> distr(mean(),sd());
-        boost::variate_generator<boost::mt19937&,decltype(distr)> randomVariate(Generator,distr);
-        return randomVariate();
+        return Autodiff::value(mean()) + Autodiff::value(sd())*Samplers::normal(Generator);
+    }
+
+    void random(std::size_t size, double* values) const {
+        Samplers::normal(Generator,values,size);
+        double mean = Autodiff::value(mean_);
+        double sd = Autodiff::value(sd_);
+        for(std::size_t index=0;index<size;index++) values[index] = mean + sd*values[index];
     }
 
     template<class Mirror>
@@ -63,6 +131,8 @@ public:
     }
 };
 
+typedef BasicNormal<> Normal;
+
 class NormalCv : public Normal {
 public:
     NormalCv(const double& mean=1, const double& cv=1):
@@ -0,0 +1,333 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <boost/random/binomial_distribution.hpp>
+
+namespace Fsl {
+namespace Math {
+namespace Probability {
+
+/**
+ * Direct samplers for random variates
+ *
+ * These are used by the `random()` methods of distributions instead of inverting
+ * the CDF (an iterative root find for many `boost::math` distributions) or constructing
+ * a `boost::variate_generator` for each draw. Each takes a reference to a 32-bit uniform
+ * random number generator (e.g. the thread local `Generator`) so it can be looked up once
+ * for many draws. Bulk versions fill a buffer of values: drawing from the generator is
+ * inherently sequential but transformations of the draws are done in separate, contiguous loops
+ * which the compiler can vectorise.
+ */
+namespace Samplers {
+
+/**
+ * A uniform random number in the open interval (0,1) with 53 bits of precision
+ */
+template<class Engine>
+inline double uniform(Engine& engine){
+    uint64_t a = static_cast<uint32_t>(engine()) >> 6;
+    uint64_t b = static_cast<uint32_t>(engine()) >> 5;
+    // 26 + 27 = 53 bits, offset by one half so that 0 is not possible
+    return ((a<<27 | b) + 0.5) * (1.0/9007199254740992.0);
+}
+
+/**
+ * Tables for the ziggurat algorithm for the standard normal distribution
+ *
+ * 128 layers as in Marsaglia and Tsang (2000), with the layer and value drawn
+ * from different bits as recommended by Doornik (2005).
+ */
+struct Ziggurat {
+    static const int layers = 128;
+    // Right hand edge of the base layer and area of each layer
+    static constexpr double r = 3.442619855899;
+    static constexpr double v = 9.91256303526217e-3;
+
+    double x[layers+1];
+    double ratios[layers];
+
+    Ziggurat(void){
+        double f = std::exp(-0.5*r*r);
+        x[0] = v/f;
+        x[1] = r;
+        for(int layer=2;layer<layers;layer++){
+            x[layer] = std::sqrt(-2*std::log(v/x[layer-1] + f));
+            f = std::exp(-0.5*x[layer]*x[layer]);
+        }
+        x[layers] = 0;
+        for(int layer=0;layer<layers;layer++) ratios[layer] = x[layer+1]/x[layer];
+    }
+
+    static const Ziggurat& instance(void){
+        static const Ziggurat ziggurat;
+        return ziggurat;
+    }
+};
+
+/**
+ * A standard normal random number using the ziggurat algorithm
+ */
+template<class Engine>
+inline double normal(Engine& engine){
+    static const Ziggurat& table = Ziggurat::instance();
+    const double r = Ziggurat::r;
+    while(true){
+        uint32_t a = static_cast<uint32_t>(engine());
+        uint32_t b = static_cast<uint32_t>(engine());
+        // Layer from the lowest 7 bits of `b`, a value in (-1,1) from the rest
+        int layer = b & 127;
+        uint64_t bits = uint64_t(a)<<21 | (b>>11);
+        double u = 2*((bits + 0.5) * (1.0/9007199254740992.0)) - 1;
+
+        // Most draws are within the rectangular part of a layer
+        if(std::fabs(u)<table.ratios[layer]) return u*table.x[layer];
+
+        if(layer==0){
+            // Draw from the tail beyond `r` (Marsaglia 1964)
+            double x, y;
+            do {
+                x = -std::log(uniform(engine))/r;
+                y = -std::log(uniform(engine));
+            } while(2*y<x*x);
+            return u<0 ? -(r+x) : r+x;
+        }
+
+        // Wedge: accept in proportion to the density
+        double x = u*table.x[layer];
+        double f0 = std::exp(-0.5*(table.x[layer]*table.x[layer]-x*x));
+        double f1 = std::exp(-0.5*(table.x[layer+1]*table.x[layer+1]-x*x));
+        if(f1 + uniform(engine)*(f0-f1) < 1) return x;
+    }
+}
+
+/**
+ * An exponential random number with rate `lambda`
+ */
+template<class Engine>
+inline double exponential(Engine& engine, double lambda = 1){
+    return -std::log(uniform(engine))/lambda;
+}
+
+/**
+ * @name Bulk samplers
+ *
+ * Fill `values` with `size` random numbers
+ *
+ * @{
+ */
+
+template<class Engine>
+inline void uniform(Engine& engine, double* values, std::size_t size){
+    for(std::size_t index=0;index<size;index++) values[index] = uniform(engine);
+}
+
+template<class Engine>
+inline void normal(Engine& engine, double* values, std::size_t size){
+    for(std::size_t index=0;index<size;index++) values[index] = normal(engine);
+}
+
+template<class Engine>
+inline void exponential(Engine& engine, double* values, std::size_t size, double lambda = 1){
+    uniform(engine,values,size);
+    for(std::size_t index=0;index<size;index++) values[index] = -std::log(values[index])/lambda;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * A standard normal random number truncated to the interval [`lower`,`upper`] (Robert 1995)
+ *
+ * Uses rejection from a normal, uniform or (for tails) translated exponential
+ * proposal, chosen so that the acceptance rate is bounded below however far into
+ * the tails, or however narrow, the interval is.
+ */
+template<class Engine>
+inline double truncated_normal(Engine& engine, double lower, double upper){
+    if(not (lower<upper)) return lower==upper?lower:NAN;
+    // Lower tail by symmetry
+    if(upper<=0) return -truncated_normal(engine,-upper,-lower);
+    if(lower<0){
+        // Interval contains zero
+        if(upper-lower>=2.5066282746310002){
+            while(true){
+                double z = normal(engine);
+                if(z>=lower and z<=upper) return z;
+            }
+        }
+        while(true){
+            double z = lower+(upper-lower)*uniform(engine);
+            if(uniform(engine)<=std::exp(-0.5*z*z)) return z;
+        }
+    }
+    // Interval is in the upper tail. Use uniform rejection if the interval is narrow
+    // relative to the optimal exponential proposal (Robert 1995, section 2.2)
+    double root = std::sqrt(lower*lower+4);
+    double alpha = (lower+root)/2;
+    double width = 2*std::sqrt(M_E)/(lower+root)*std::exp((lower*lower-lower*root)/4);
+    if(upper-lower<=width){
+        while(true){
+            double z = lower+(upper-lower)*uniform(engine);
+            if(uniform(engine)<=std::exp(0.5*(lower*lower-z*z))) return z;
+        }
+    }
+    while(true){
+        double z = lower+exponential(engine,alpha);
+        if(z<=upper and uniform(engine)<=std::exp(-0.5*(z-alpha)*(z-alpha))) return z;
+    }
+}
+
+/**
+ * A gamma random number with `shape` and unit scale (Marsaglia and Tsang 2000)
+ */
+template<class Engine>
+inline double gamma(Engine& engine, double shape){
+    if(not (shape>0 and std::isfinite(shape))) return NAN;
+    if(shape<1){
+        // Boost to shape+1 and scale down (Marsaglia and Tsang 2000, section 6)
+        return gamma(engine,shape+1)*std::pow(uniform(engine),1/shape);
+    }
+    double d = shape-1.0/3;
+    double c = 1/std::sqrt(9*d);
+    while(true){
+        double x, v;
+        do {
+            x = normal(engine);
+            v = 1+c*x;
+        } while(v<=0);
+        v = v*v*v;
+        double u = uniform(engine);
+        double x2 = x*x;
+        if(u<1-0.0331*x2*x2) return d*v;
+        if(std::log(u)<0.5*x2+d*(1-v+std::log(v))) return d*v;
+    }
+}
+
+/**
+ * A beta random number from the ratio of gamma random numbers
+ */
+template<class Engine>
+inline double beta(Engine& engine, double alpha, double beta){
+    double x = gamma(engine,alpha);
+    double y = gamma(engine,beta);
+    return x/(x+y);
+}
+
+/**
+ * Alias table for sampling from a discrete distribution in constant time (Vose 1991)
+ *
+ * Each draw uses one uniform random number: its integer part (after scaling by the number of
+ * categories) selects a column of the table and its fractional part decides between the column's
+ * category and its alias.
+ */
+struct Alias {
+    std::vector<double> probabilities;
+    std::vector<std::size_t> aliases;
+
+    Alias(void){
+    }
+
+    /**
+     * Construct from `size` non-negative weights (which need not sum to one)
+     */
+    Alias(const double* weights, std::size_t size):
+        probabilities(size),
+        aliases(size){
+        double sum = 0;
+        for(std::size_t index=0;index<size;index++) sum += weights[index];
+        std::vector<double> scaled(size);
+        std::vector<std::size_t> smalls, larges;
+        for(std::size_t index=0;index<size;index++){
+            scaled[index] = weights[index]*size/sum;
+            if(scaled[index]<1) smalls.push_back(index);
+            else larges.push_back(index);
+        }
+        while(not smalls.empty() and not larges.empty()){
+            std::size_t small = smalls.back();
+            smalls.pop_back();
+            std::size_t large = larges.back();
+            probabilities[small] = scaled[small];
+            aliases[small] = large;
+            scaled[large] -= 1-scaled[small];
+            if(scaled[large]<1){
+                larges.pop_back();
+                smalls.push_back(large);
+            }
+        }
+        // Remaining columns are full (up to rounding error)
+        for(std::size_t index : larges){
+            probabilities[index] = 1;
+            aliases[index] = index;
+        }
+        for(std::size_t index : smalls){
+            probabilities[index] = 1;
+            aliases[index] = index;
+        }
+    }
+
+    Alias(const std::vector<double>& weights):
+        Alias(weights.data(),weights.size()){
+    }
+
+    std::size_t size(void) const {
+        return probabilities.size();
+    }
+
+    /**
+     * Draw the index of a category
+     */
+    template<class Engine>
+    std::size_t operator()(Engine& engine) const {
+        if(probabilities.empty()) return 0;
+        double x = uniform(engine)*probabilities.size();
+        std::size_t column = static_cast<std::size_t>(x);
+        if(column>=probabilities.size()) column = probabilities.size()-1;
+        return (x-column)<probabilities[column]?column:aliases[column];
+    }
+};
+
+/**
+ * A binomial random number (Hormann 1993, as implemented by `boost::random`)
+ */
+template<class Engine>
+inline double binomial(Engine& engine, double trials, double probability){
+    if(not (trials>=0 and probability>=0 and probability<=1)) return NAN;
+    if(trials==0 or probability==0) return 0;
+    if(probability==1) return trials;
+    boost::random::binomial_distribution<long,double> binomial(static_cast<long>(trials),probability);
+    return binomial(engine);
+}
+
+/**
+ * Multinomial counts from `trials` over `bins` with `probabilities` (which need not sum to one)
+ *
+ * When there are fewer trials than bins, each trial is drawn using an alias table. Otherwise,
+ * counts are drawn as a sequence of binomials, each conditional on the counts in preceding bins,
+ * so that the cost is proportional to the number of bins regardless of the number of trials.
+ */
+template<class Engine>
+inline void multinomial(Engine& engine, double trials, const double* probabilities, std::size_t bins, double* counts){
+    for(std::size_t bin=0;bin<bins;bin++) counts[bin] = 0;
+    if(trials<bins){
+        Alias alias(probabilities,bins);
+        for(long trial=0;trial<trials;trial++) counts[alias(engine)]++;
+        return;
+    }
+    double remaining = 0;
+    for(std::size_t bin=0;bin<bins;bin++) remaining += probabilities[bin];
+    for(std::size_t bin=0;bin<bins and trials>0;bin++){
+        double probability = remaining>0?std::min(probabilities[bin]/remaining,1.0):0;
+        counts[bin] = bin+1<bins?binomial(engine,trials,probability):trials;
+        trials -= counts[bin];
+        remaining -= probabilities[bin];
+    }
+}
+
+} // namespace Samplers
+
+}}}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <fsl/math/probability/distribution.hpp>
+
+namespace Fsl {
+namespace Math {
+namespace Probability {
+
+/**
+ * A distribution tabulated at a grid of values
+ *
+ * Constructed from ascending `values` and the relative probability of each. The
+ * normalised cumulative probabilities are calculated once so that `quantile()`, and
+ * therefore `random()`, is a binary search followed by linear interpolation between
+ * grid values. Intended for empirical priors (e.g. `SteepnessHe2006`) which can keep a table
+ * for each combination of their parameters rather than recalculating it for every draw.
+ */
+class Tabulated {
+public:
+
+    Tabulated(void){
+    }
+
+    Tabulated(const std::vector<double>& values, const std::vector<double>& weights):
+        values_(values),
+        cumulatives_(weights.size()){
+        if(values.size()!=weights.size() or values.empty()) {
+            throw std::runtime_error("`Tabulated` : values and weights must be the same, non-zero, size");
+        }
+        double sum = 0;
+        for(std::size_t index=0;index<weights.size();index++){
+            sum += weights[index];
+            cumulatives_[index] = sum;
+        }
+        for(double& cumulative : cumulatives_) cumulative /= sum;
+    }
+
+    const std::vector<double>& values(void) const {
+        return values_;
+    }
+
+    const std::vector<double>& cumulatives(void) const {
+        return cumulatives_;
+    }
+
+    double minimum(void) const {
+        return values_.front();
+    }
+
+    double maximum(void) const {
+        return values_.back();
+    }
+
+    /**
+     * Value at which the cumulative probability is `p`, interpolated linearly
+     * between the grid values either side of it
+     */
+    double quantile(const double& p) const {
+        std::size_t step = std::lower_bound(cumulatives_.begin(),cumulatives_.end(),p)-cumulatives_.begin();
+        if(step==0) return values_.front();
+        if(step==cumulatives_.size()) return values_.back();
+        double hi = cumulatives_[step];
+        double lo = cumulatives_[step-1];
+        return values_[step-1]+(values_[step]-values_[step-1])*(p-lo)/(hi-lo);
+    }
+
+    double random(void) const {
+        return quantile(Samplers::uniform(Generator));
+    }
+
+private:
+
+    std::vector<double> values_;
+    std::vector<double> cumulatives_;
+};
+
+}}}
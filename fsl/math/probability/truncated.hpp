@@ -1,5 +1,8 @@
 #pragma once
 
+#include <fsl/math/probability/normal.hpp>
+#include <fsl/math/probability/lognormal.hpp>
+
 namespace Fsl {
 namespace Math {
 namespace Probability {
@@ -21,11 +24,59 @@ public:
 		return max;
 	}
 
+	/*!
+	Generate an exact random number from the truncated distribution
+
+	The cost of each draw is bounded regardless of how extreme the truncation is:
+	normal and lognormal distributions use `Samplers::truncated_normal()` and others invert the
+	CDF between the CDF at `min` and `max`.
+	*/
 	double random(void) const {
-		double trial = Base::random();
-		if(trial<min or trial>max) return random();
-		else return trial;
+		return random_(static_cast<const Base&>(*this));
 	};
+
+private:
+
+	template<class Distribution>
+	double random_(const Distribution& base) const {
+		if(not base.valid()) return NAN;
+		if(not (min<=max)) return NAN;
+		auto dist = base.boost_dist();
+		// Use the upper tail probabilities in the upper half of the distribution so
+		// that precision is not lost when truncated far in the upper tail
+		bool upper = std::isfinite(min) and boost::math::cdf(dist,min)>0.5;
+		double trial;
+		if(upper){
+			double from = std::isfinite(max)?boost::math::cdf(boost::math::complement(dist,max)):0;
+			double to = boost::math::cdf(boost::math::complement(dist,min));
+			if(not (to>from)) return NAN;
+			trial = boost::math::quantile(boost::math::complement(dist,from+(to-from)*Samplers::uniform(Generator)));
+		} else {
+			double from = std::isfinite(min)?boost::math::cdf(dist,min):0;
+			double to = std::isfinite(max)?boost::math::cdf(dist,max):1;
+			if(not (to>from)) return NAN;
+			trial = boost::math::quantile(dist,from+(to-from)*Samplers::uniform(Generator));
+		}
+		return std::min(std::max(trial,min),max);
+	}
+
+	template<typename Scalar>
+	double random_(const BasicNormal<Scalar>& base) const {
+		if(not base.valid()) return NAN;
+		double mean = Autodiff::value(base.mean());
+		double sd = Autodiff::value(base.sd());
+		return mean+sd*Samplers::truncated_normal(Generator,(min-mean)/sd,(max-mean)/sd);
+	}
+
+	double random_(const Lognormal& base) const {
+		if(not base.valid()) return NAN;
+		// Truncated normal in log space, with the same parameters as `Lognormal::random()`
+		double mu = base.log_location();
+		double sigma = base.log_dispersion();
+		double lower = min>0?(std::log(min)-mu)/sigma:-INFINITY;
+		double upper = (std::log(max)-mu)/sigma;
+		return std::exp(mu+sigma*Samplers::truncated_normal(Generator,lower,upper));
+	}
 };
 
 }}}
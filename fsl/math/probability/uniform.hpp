@@ -47,14 +47,14 @@ public:
     }
     
     double random(void) const {
-        // If lower and upper are equal then boost random number generator
-        // will loop endlessly attempting to create a valid value. So escape that condition...
         if(lower==upper) return lower;
-        else{
-            boost::uniform_real<> distr(lower,upper);
-            boost::variate_generator<boost::mt19937&,decltype(distr)> randomVariate(Generator,distr);
-            return randomVariate();
-        }
+        else return lower + (upper-lower)*Samplers::uniform(Generator);
+    }
+
+    void random(std::size_t size, double* values) const {
+        Samplers::uniform(Generator,values,size);
+        double range = upper-lower;
+        for(std::size_t index=0;index<size;index++) values[index] = lower + range*values[index];
     }
 
     bool accept(const double& value) const {
@@ -0,0 +1,62 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/quadrature/gauss.hpp>
+
+BOOST_AUTO_TEST_SUITE(quadrature)
+
+using namespace Fsl::Math::Quadrature;
+
+BOOST_AUTO_TEST_CASE(hermite){
+    const Hermite<>& hermite = Hermite<>::instance();
+    double sum = 0;
+    for(double weight : hermite.weights) sum += weight;
+    BOOST_CHECK_CLOSE(sum,1,1e-10);
+
+    // Moments of N(2,3)
+    auto identity = [](double x){ return x; };
+    auto square = [](double x){ return x*x; };
+    auto quartic = [](double x){ return std::pow(x-2,4); };
+    BOOST_CHECK_CLOSE(hermite.integrate(identity,2.0,3.0),2,1e-10);
+    BOOST_CHECK_CLOSE(hermite.integrate(square,2.0,3.0),13,1e-10);
+    BOOST_CHECK_CLOSE(hermite.integrate(quartic,2.0,3.0),3*81,1e-10);
+
+    // Batch
+    double means[] = {1,2,3};
+    double sds[] = {0.1,0.2,0.3};
+    double results[3];
+    hermite.integrate(square,means,sds,3,results);
+    for(int index=0;index<3;index++){
+        BOOST_CHECK_CLOSE(results[index],means[index]*means[index]+sds[index]*sds[index],1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(central){
+    const Central<>& central = Central<>::instance();
+    double sum = 0;
+    for(unsigned int i=0;i<10;i++){
+        sum += central.weights[i];
+        // Nodes are within the central 99.9%
+        BOOST_CHECK(std::fabs(central.nodes[i])<Central<>::bound);
+    }
+    BOOST_CHECK_CLOSE(sum,1,1e-10);
+
+    // Mean is exact (by symmetry) and the variance is that of a normal
+    // truncated to the central 99.9%
+    auto identity = [](double x){ return x; };
+    auto square = [](double x){ return std::pow(x-2,2); };
+    const double z = Central<>::bound;
+    double variance = 1-2*z*std::exp(-0.5*z*z)/std::sqrt(2*M_PI)/0.999;
+    BOOST_CHECK_CLOSE(central.integrate(identity,2.0,3.0),2,1e-10);
+    BOOST_CHECK_CLOSE(central.integrate(square,2.0,3.0),9*variance,0.01);
+}
+
+BOOST_AUTO_TEST_CASE(legendre){
+    const Legendre<>& legendre = Legendre<>::instance();
+    BOOST_CHECK_CLOSE(legendre.integrate([](double x){ return std::pow(x,7); },0.0,2.0),32,1e-10);
+    BOOST_CHECK_CLOSE(legendre.integrate([](double x){ return std::sin(x); },0.0,M_PI),2,1e-8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+namespace Fsl {
+namespace Math {
+namespace Quadrature {
+
+/**
+ * A quadrature rule for expectations over a normal distribution with nodes
+ * in standard units and weights summing to one
+ *
+ *     E[f(X)] ~ sum_i weights[i]*f(mean + sd*nodes[i]),   X ~ N(mean,sd)
+ *
+ * @tparam Points Number of nodes
+ */
+template<
+    unsigned int Points
+>
+struct Standard {
+    double nodes[Points];
+    double weights[Points];
+
+    /**
+     * Expected value of `function` over a normal distribution
+     */
+    template<class Function, class Scalar>
+    Scalar integrate(Function function, const Scalar& mean, const Scalar& sd) const {
+        Scalar sum = 0;
+        for(unsigned int i=0;i<Points;i++) sum += weights[i]*function(mean+sd*nodes[i]);
+        return sum;
+    }
+
+    /**
+     * Expected values of `function` over `size` normal distributions
+     *
+     * Loops over nodes, then distributions, so that each node is
+     * applied to contiguous arrays of parameters.
+     */
+    template<class Function>
+    void integrate(Function function, const double* means, const double* sds, std::size_t size, double* results) const {
+        for(std::size_t index=0;index<size;index++) results[index] = 0;
+        for(unsigned int i=0;i<Points;i++){
+            const double node = nodes[i];
+            const double weight = weights[i];
+            for(std::size_t index=0;index<size;index++){
+                results[index] += weight*function(means[index]+sds[index]*node);
+            }
+        }
+    }
+};
+
+/**
+ * Gauss-Hermite quadrature for expectations over a normal distribution
+ *
+ * Nodes and weights are for the standard normal density (i.e. the "probabilists'"
+ * rule with weights summing to one) so that
+ *
+ *     E[f(X)] ~ sum_i weights[i]*f(mean + sd*nodes[i]),   X ~ N(mean,sd)
+ *
+ * which is exact for polynomials of degree up to `2*Points-1`. Nodes and weights are
+ * calculated once (by Newton iteration on the Hermite polynomials) and shared.
+ *
+ * The outer nodes are far into the tails (e.g. +/-4.86 sd for 10 points) so only use this
+ * for functions defined over the whole real line (otherwise see `Central`).
+ *
+ * @tparam Points Number of nodes
+ */
+template<
+    unsigned int Points = 10
+>
+struct Hermite : Standard<Points> {
+    using Standard<Points>::nodes;
+    using Standard<Points>::weights;
+
+    Hermite(void){
+        // Nodes and weights for the weight function exp(-x^2) (Press et al. 2007, section 4.6)
+        // converted to those for the standard normal density
+        const double pim4 = 0.7511255444649425;
+        const int n = Points;
+        double z = 0;
+        for(int i=0;i<(n+1)/2;i++){
+            if(i==0) z = std::sqrt(2.0*n+1)-1.85575*std::pow(2.0*n+1,-0.16667);
+            else if(i==1) z -= 1.14*std::pow(double(n),0.426)/z;
+            else if(i==2) z = 1.86*z-0.86*nodes[0];
+            else if(i==3) z = 1.91*z-0.91*nodes[1];
+            else z = 2*z-nodes[i-2];
+            double pp = 0;
+            for(int iteration=0;iteration<100;iteration++){
+                double p1 = pim4;
+                double p2 = 0;
+                for(int j=0;j<n;j++){
+                    double p3 = p2;
+                    p2 = p1;
+                    p1 = z*std::sqrt(2.0/(j+1))*p2-std::sqrt(double(j)/(j+1))*p3;
+                }
+                pp = std::sqrt(2.0*n)*p2;
+                double last = z;
+                z = last-p1/pp;
+                if(std::fabs(z-last)<=1e-15) break;
+            }
+            // Unscaled, for use in the initial guesses above
+            nodes[i] = z;
+            nodes[n-1-i] = -z;
+            weights[i] = weights[n-1-i] = 2/(pp*pp);
+        }
+        for(int i=0;i<n;i++){
+            nodes[i] *= std::sqrt(2.0);
+            weights[i] /= std::sqrt(M_PI);
+        }
+    }
+
+    static const Hermite& instance(void){
+        static const Hermite hermite;
+        return hermite;
+    }
+};
+
+/**
+ * Gauss-Legendre quadrature for integrals over a bounded interval
+ *
+ *     integral of f(x) from a to b ~ (b-a)/2 * sum_i weights[i]*f((a+b)/2 + (b-a)/2*nodes[i])
+ *
+ * which is exact for polynomials of degree up to `2*Points-1`. Nodes are in (-1,1) so
+ * functions are not evaluated at the bounds.
+ *
+ * @tparam Points Number of nodes
+ */
+template<
+    unsigned int Points = 10
+>
+struct Legendre {
+    double nodes[Points];
+    double weights[Points];
+
+    Legendre(void){
+        const int n = Points;
+        for(int i=0;i<(n+1)/2;i++){
+            double z = std::cos(M_PI*(i+0.75)/(n+0.5));
+            double pp = 0;
+            for(int iteration=0;iteration<100;iteration++){
+                double p1 = 1;
+                double p2 = 0;
+                for(int j=0;j<n;j++){
+                    double p3 = p2;
+                    p2 = p1;
+                    p1 = ((2*j+1)*z*p2-j*p3)/(j+1);
+                }
+                pp = n*(z*p1-p2)/(z*z-1);
+                double last = z;
+                z = last-p1/pp;
+                if(std::fabs(z-last)<=1e-15) break;
+            }
+            nodes[i] = -z;
+            nodes[n-1-i] = z;
+            weights[i] = weights[n-1-i] = 2/((1-z*z)*pp*pp);
+        }
+    }
+
+    static const Legendre& instance(void){
+        static const Legendre legendre;
+        return legendre;
+    }
+
+    /**
+     * Integral of `function` from `from` to `to`
+     */
+    template<class Function, class Scalar>
+    Scalar integrate(Function function, const Scalar& from, const Scalar& to) const {
+        Scalar middle = (from+to)/2;
+        Scalar half = (to-from)/2;
+        Scalar sum = 0;
+        for(unsigned int i=0;i<Points;i++) sum += weights[i]*function(middle+half*nodes[i]);
+        return half*sum;
+    }
+};
+
+/**
+ * Gauss-Legendre quadrature for expectations over the central 99.9% of a normal distribution
+ *
+ * Nodes are within the 0.0005 and 0.9995 quantiles (as for `Distribution::integrate()`) and
+ * weights are the Legendre weights times the standard normal density, normalised to sum to one.
+ * Unlike `Hermite`, functions are not evaluated far into the tails, where they may not be
+ * defined (e.g. a weight-length relationship with a non-integer exponent at negative lengths).
+ *
+ * @tparam Points Number of nodes
+ */
+template<
+    unsigned int Points = 10
+>
+struct Central : Standard<Points> {
+    using Standard<Points>::nodes;
+    using Standard<Points>::weights;
+
+    /**
+     * Standard normal quantile for 0.9995
+     */
+    static constexpr double bound = 3.2905267314919255;
+
+    Central(void){
+        const Legendre<Points>& legendre = Legendre<Points>::instance();
+        double sum = 0;
+        for(unsigned int i=0;i<Points;i++){
+            nodes[i] = bound*legendre.nodes[i];
+            weights[i] = legendre.weights[i]*std::exp(-0.5*nodes[i]*nodes[i]);
+            sum += weights[i];
+        }
+        for(unsigned int i=0;i<Points;i++) weights[i] /= sum;
+    }
+
+    static const Central& instance(void){
+        static const Central central;
+        return central;
+    }
+};
+
+}}}
@@ -0,0 +1,47 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/math/series/arma.hpp>
+#include <fsl/math/series/autocorrelation.hpp>
+
+BOOST_AUTO_TEST_SUITE(arma)
+
+using namespace Fsl::Math::Series;
+
+BOOST_AUTO_TEST_CASE(ar1){
+    // Same innovations give the same series as `Autocorrelation`
+    Fsl::Math::Probability::Generator.seed(42);
+    Arma arma({0.6});
+    arma.generate(3,50);
+
+    Fsl::Math::Probability::Generator.seed(42);
+    std::vector<double> innovations(3*50);
+    Fsl::Math::Probability::Samplers::normal(Fsl::Math::Probability::Generator,innovations.data(),innovations.size());
+    Autocorrelation autocorrelation(0.6);
+    for(unsigned int step=0;step<50;step++){
+        BOOST_CHECK_CLOSE(arma(1,step),autocorrelation(innovations[step*3+1]),1e-10);
+    }
+    BOOST_CHECK_EQUAL(arma.series(1).size(),50u);
+}
+
+BOOST_AUTO_TEST_CASE(moments){
+    // Unit variance and expected lag one autocorrelation
+    Arma arma({0.5},{0.4});
+    arma.generate(2000,50);
+    double sum = 0, squares = 0, products = 0;
+    for(unsigned int replicate=0;replicate<2000;replicate++){
+        sum += arma(replicate,49);
+        squares += std::pow(arma(replicate,49),2);
+        products += arma(replicate,48)*arma(replicate,49);
+    }
+    BOOST_CHECK_SMALL(sum/2000,0.1);
+    BOOST_CHECK_CLOSE(squares/2000,1,10);
+    // rho(1) = (1+phi*theta)*(phi+theta)/(1+2*phi*theta+theta^2)
+    BOOST_CHECK_CLOSE(products/2000,1.2*0.9/1.56,15);
+
+    BOOST_CHECK_THROW(Arma({1.2}).generate(1,1),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <fsl/math/probability/distribution.hpp>
+#include <fsl/math/probability/samplers.hpp>
+
+namespace Fsl {
+namespace Math {
+namespace Series {
+
+/**
+ * Tapes of autocorrelated, standard normal deviations
+ *
+ * Generates the deviations for a whole projection, for a number of replicates, at once
+ * so that they can be reused (e.g. by `Autocorrelated::tape()` and `Cpue::tape()`)
+ * for every candidate evaluated within a replicate. Deviations follow an
+ * ARMA(p,q) process,
+ *
+ *     x[t] = ar[0]*x[t-1] + ... + ar[p-1]*x[t-p] + s*(e[t] + ma[0]*e[t-1] + ... + ma[q-1]*e[t-q])
+ *
+ * with the innovations scaled by `s` so that the series have unit marginal variance.
+ * For an AR(1) process the series start from the stationary distribution and are identical
+ * to those produced by `Autocorrelation` from the same innovations. Otherwise, the first `burnin`
+ * steps are discarded.
+ *
+ * Tapes are stored step major (all replicates for step 0, then step 1 etc) so that
+ * the recursion is a contiguous loop over replicates which the compiler can vectorise.
+ */
+class Arma {
+public:
+
+    /**
+     * Autoregressive coefficients
+     */
+    std::vector<double> ar;
+
+    /**
+     * Moving average coefficients
+     */
+    std::vector<double> ma;
+
+    /**
+     * Number of steps discarded for processes other than AR(1)
+     */
+    unsigned int burnin = 100;
+
+    Arma(const std::vector<double>& ar_ = {}, const std::vector<double>& ma_ = {}):
+        ar(ar_),
+        ma(ma_){
+    }
+
+    /**
+     * Scale of innovations which gives unit marginal variance
+     *
+     * Calculated from the sum of squares of the process' psi weights (its
+     * moving average representation)
+     */
+    double scale(void) const {
+        if(ar.size()==1 and ma.empty()) {
+            if(std::fabs(ar[0])>1) throw std::runtime_error("`Arma` : process is not stationary");
+            return std::sqrt(1-ar[0]*ar[0]);
+        }
+        const std::size_t terms = 10000;
+        std::vector<double> psis(terms);
+        double sum = 0;
+        for(std::size_t j=0;j<terms;j++){
+            double psi = j==0 ? 1 : (j<=ma.size() ? ma[j-1] : 0);
+            for(std::size_t i=0;i<ar.size() and i<j;i++) psi += ar[i]*psis[j-i-1];
+            psis[j] = psi;
+            sum += psi*psi;
+        }
+        if(not std::isfinite(sum) or std::fabs(psis[terms-1])>1e-8) {
+            throw std::runtime_error("`Arma` : process is not stationary");
+        }
+        return 1/std::sqrt(sum);
+    }
+
+    /**
+     * Generate tapes using the thread local `Generator`
+     */
+    Arma& generate(std::size_t replicates, std::size_t steps){
+        return generate(Probability::Generator,replicates,steps);
+    }
+
+    /**
+     * Generate tapes of `steps` deviations for each of `replicates`
+     */
+    template<class Engine>
+    Arma& generate(Engine& engine, std::size_t replicates, std::size_t steps){
+        replicates_ = replicates;
+        steps_ = steps;
+        double s = scale();
+        if(ar.size()==1 and ma.empty()){
+            tape_.resize(replicates*steps);
+            // Draw innovations in bulk, in replicate order within each step
+            Probability::Samplers::normal(engine,tape_.data(),tape_.size());
+            double phi = ar[0];
+            for(std::size_t step=1;step<steps;step++){
+                double* current = &tape_[step*replicates];
+                const double* previous = current - replicates;
+                for(std::size_t replicate=0;replicate<replicates;replicate++){
+                    current[replicate] = phi*previous[replicate] + s*current[replicate];
+                }
+            }
+        } else {
+            std::size_t total = burnin+steps;
+            std::vector<double> innovations(replicates*total);
+            Probability::Samplers::normal(engine,innovations.data(),innovations.size());
+            for(double& innovation : innovations) innovation *= s;
+            std::vector<double> series(replicates*total);
+            for(std::size_t step=0;step<total;step++){
+                double* current = &series[step*replicates];
+                const double* innovation = &innovations[step*replicates];
+                for(std::size_t replicate=0;replicate<replicates;replicate++) current[replicate] = innovation[replicate];
+                for(std::size_t lag=1;lag<=ar.size() and lag<=step;lag++){
+                    double phi = ar[lag-1];
+                    const double* previous = current - lag*replicates;
+                    for(std::size_t replicate=0;replicate<replicates;replicate++) current[replicate] += phi*previous[replicate];
+                }
+                for(std::size_t lag=1;lag<=ma.size() and lag<=step;lag++){
+                    double theta = ma[lag-1];
+                    const double* previous = innovation - lag*replicates;
+                    for(std::size_t replicate=0;replicate<replicates;replicate++) current[replicate] += theta*previous[replicate];
+                }
+            }
+            tape_.assign(series.begin()+burnin*replicates,series.end());
+        }
+        return *this;
+    }
+
+    std::size_t replicates(void) const {
+        return replicates_;
+    }
+
+    std::size_t steps(void) const {
+        return steps_;
+    }
+
+    /**
+     * Deviation for a replicate at a step
+     */
+    double operator()(std::size_t replicate, std::size_t step) const {
+        return tape_[step*replicates_+replicate];
+    }
+
+    /**
+     * Deviations for all steps of a replicate
+     */
+    std::vector<double> series(std::size_t replicate) const {
+        if(replicate>=replicates_) throw std::runtime_error("`Arma::series` : no such replicate");
+        std::vector<double> series(steps_);
+        for(std::size_t step=0;step<steps_;step++) series[step] = tape_[step*replicates_+replicate];
+        return series;
+    }
+
+private:
+
+    std::size_t replicates_ = 0;
+    std::size_t steps_ = 0;
+    std::vector<double> tape_;
+};
+
+}
+}
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cmath>
+#include <cstddef>
+
 namespace Fsl {
 namespace Math {
 namespace Series {
@@ -10,6 +13,13 @@ private:
     bool started_;
     double last_;
 
+    /**
+     * Cached value of `sqrt(1-coefficient^2)` and the coefficient
+     * it was calculated for
+     */
+    double scale_coefficient_;
+    double scale_;
+
 public:
 
     double coefficient;
@@ -17,12 +27,18 @@ public:
     Autocorrelation(double coefficient_ = 0):
         started_(false),
         last_(0),
+        scale_coefficient_(NAN),
+        scale_(NAN),
         coefficient(coefficient_){
     }
 
     double operator()(const double& deviation) {
         if(started_) {
-            last_ = coefficient*last_ + std::sqrt(1-std::pow(coefficient,2))*deviation;
+            if(coefficient!=scale_coefficient_){
+                scale_coefficient_ = coefficient;
+                scale_ = std::sqrt(1-coefficient*coefficient);
+            }
+            last_ = coefficient*last_ + scale_*deviation;
         }
         else {
             last_ = deviation;
@@ -30,6 +46,13 @@ public:
         }
         return last_;
     }
+
+    /**
+     * Apply autocorrelation to a series of deviations in place
+     */
+    void operator()(double* deviations, std::size_t size) {
+        for(std::size_t index=0;index<size;index++) deviations[index] = (*this)(deviations[index]);
+    }
 };
 
 }
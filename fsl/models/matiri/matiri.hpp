@@ -56,6 +56,9 @@ using Fsl::Population::Recruitment::Autocorrelated;
 
 #include <fsl/population/recruitment/beverton-holt.hpp>
 using Fsl::Population::Recruitment::BevertonHolt;
+using Fsl::Population::Recruitment::BasicBevertonHolt;
+
+#include <fsl/math/autodiff/reverse.hpp>
 
 enum Binary {no=0,yes=1};
 
@@ -75,7 +78,7 @@ public:
     template<
         class... Args
     >
-    double operator()(Args... args){
+    auto operator()(Args... args) -> decltype(On::operator()(args...)) {
         return state_?
             On::operator()(args...):
             Off::operator()(args...);
@@ -97,6 +100,10 @@ namespace Models {
 
 /**
  * Sex, age and sector structured fishery model.
+ *
+ * The `Scalar` type is used for parameters and state so that, by using
+ * `Math::Autodiff::Reverse`, exact derivatives of the likelihood with respect to parameters
+ * can be obtained from a single model run.
  * 
  * @author Nokome Bentley <nokome.bentley@trophia.com>
  */
@@ -104,7 +111,8 @@ template<
     class Derived,
     unsigned int Sexes,
     unsigned int Ages,
-    unsigned int Sectors
+    unsigned int Sectors,
+    typename Scalar = double
 >
 class Matiri : public Polymorph<Derived> {
 public:
@@ -137,12 +145,12 @@ public:
     /**
      * Fish numbers by age and sex
      */
-    Array<double,Sex,Age> numbers = 0;
+    Array<Scalar,Sex,Age> numbers = Scalar(0);
 
     /**
      * Fish biomass
      */
-    double biomass = 0;
+    Scalar biomass = 0;
 
     /**
      * @name Spawning
@@ -152,7 +160,7 @@ public:
     /**
      * Fish spawning biomass
      */
-    double biomass_spawning = 0;
+    Scalar biomass_spawning = 0;
 
     /**
      * @}
@@ -166,7 +174,7 @@ public:
     /**
      * BevertonHolt or Constant recruitment relation
      */
-    Switch<BevertonHolt,Constant> recruitment_relation;
+    Switch<BasicBevertonHolt<Scalar>,Constant> recruitment_relation;
 
     /**
      * Lognormal or Constant recruitment variation
@@ -182,20 +190,20 @@ public:
     /**
      * Deterministic recruitment at time t 
      */
-    double recruits_determ = 0;
+    Scalar recruits_determ = 0;
 
     /**
      * Recruitment deviation (multiplier) at time t
      */
-    double recruits_deviation = 1;
+    Scalar recruits_deviation = 1;
 
     /**
      * Total number of recruits at time t
      */
-    double recruits = 0;
+    Scalar recruits = 0;
 
     
-    double sex_ratio = 0.5;
+    Scalar sex_ratio = 0.5;
 
     /**
      * @}
@@ -210,7 +218,7 @@ public:
      * Instantaneous rate of natural mortality for each sex
      */
     Array<
-        double,
+        Scalar,
         Sex
     > mortality;
 
@@ -218,7 +226,7 @@ public:
      * Mortality at sex and age
      */
     Array<
-        double,
+        Scalar,
         Sex,Age
     > mortalities;
 
@@ -226,7 +234,7 @@ public:
      * Survival at sex and age
      */
     Array<
-        double,
+        Scalar,
         Sex,Age
     > mortality_survivals;
 
@@ -243,14 +251,14 @@ public:
      * Length at age
      */
     
-    struct LengthAge : VonBert {
-        double cv1;
-        double cv2;
-
-        Normal distribution(const double& age){
-            auto mean = VonBert::operator()(age);
-            auto sd = mean * cv1;
-            return Normal(mean,sd);
+    struct LengthAge : Population::Growth::BasicVonBert<Scalar> {
+        Scalar cv1;
+        Scalar cv2;
+
+        Math::Probability::BasicNormal<Scalar> distribution(const Scalar& age){
+            Scalar mean = this->value(age);
+            Scalar sd = mean * cv1;
+            return Math::Probability::BasicNormal<Scalar>(mean,sd);
         }
     };
 
@@ -260,7 +268,7 @@ public:
     > length_age;
 
     Array<
-        Normal,
+        Math::Probability::BasicNormal<Scalar>,
         Sex,Age
     > lengths;
 
@@ -269,12 +277,12 @@ public:
      */
     
     Array<
-        Power,
+        Math::Functions::BasicPower<Scalar>,
         Sex
     > weight_length;
     
     Array<
-        double,
+        Scalar,
         Sex,Age
     > weights;
 
@@ -283,12 +291,12 @@ public:
      */
     
     Array<
-        Logistic,
+        Math::Functions::BasicLogistic<Scalar>,
         Sex
     > maturity_age;
 
     Array<
-        double,
+        Scalar,
         Sex,Age
     > maturities;
 
@@ -297,17 +305,17 @@ public:
      */
     
     Array<
-        double,
+        Scalar,
         Sector,Sex
-    > selectivity_sex = 1;
+    > selectivity_sex = Scalar(1);
 
     Array<
-        DoubleNormalPlateau,
+        Math::Functions::BasicDoubleNormalPlateau<Scalar>,
         Sector,Sex
     > selectivity_age;
     
     Array<
-        double,
+        Scalar,
         Sector,Sex,Age
     > selectivities;
 
@@ -327,35 +335,35 @@ public:
     /**
      * Vulnerable biomass by sector
      */
-    Array<double,Sector> biomass_vulnerable = 0;
+    Array<Scalar,Sector> biomass_vulnerable = Scalar(0);
 
     /**
      * Vulnerable biomass that is spawners by sector
      */
-    Array<double,Sector> biomass_vulnerable_spawning = 0;
+    Array<Scalar,Sector> biomass_vulnerable_spawning = Scalar(0);
 
     /**
      * Catches by sector
      */
-    Array<double,Sector> catches = 0;
+    Array<Scalar,Sector> catches = Scalar(0);
 
-    Array<double,Sector> exploitation_rate_max = 1;
+    Array<Scalar,Sector> exploitation_rate_max = Scalar(1);
 
     /**
      * Exploitation rate by region and method for current time step
      */
-    Array<double,Sector> exploitation_rate = 0;
+    Array<Scalar,Sector> exploitation_rate = Scalar(0);
 
     /**
      * Exploitation survival by sex and age
      */
-    Array<double,Sex,Age> exploitation_survivals = 1;
+    Array<Scalar,Sex,Age> exploitation_survivals = Scalar(1);
 
     /**
      * @}
      */
     
-    double biomass_update(void){
+    Scalar biomass_update(void){
         biomass = 0;
         for(auto sex : sexes){
             for(auto age : ages){
@@ -366,7 +374,7 @@ public:
         return biomass;
     }
     
-    double biomass_spawning_update(void){
+    Scalar biomass_spawning_update(void){
         biomass_spawning = 0;
         for(auto sex : sexes){
             for(auto age : ages){
@@ -379,7 +387,7 @@ public:
 
     void biomass_vulnerable_update(void){
         for(auto sector : sectors){
-            double sum = 0;
+            Scalar sum = 0;
             for(auto sex : sexes){
                 for(auto age : ages){
                     sum += numbers(sex,age) * weights(sex,age) * selectivities(sector,sex,age);
@@ -391,7 +399,7 @@ public:
 
     void biomass_vulnerable_spawning_update(void){
         for(auto sector : sectors){
-            double sum = 0;
+            Scalar sum = 0;
             for(auto sex : sexes){
                 for(auto age : ages){
                     sum += numbers(sex,age) * weights(sex,age) * maturities(sex,age) * selectivities(sector,sex,age);
@@ -404,20 +412,20 @@ public:
     void exploitation_off(void){
         exploitation_on = false;
         catches_on = false;
-        exploitation_rate = 0;  
+        exploitation_rate = Scalar(0);  
     }
 
     /**
      * Set exploitation rate. Used in testing and in 
      * equilibrium exploitation i.e. MSY/BMSY calculations
      */
-    void exploitation_rate_set(const Array<double,Sector>& values){
+    void exploitation_rate_set(const Array<Scalar,Sector>& values){
         exploitation_on = true;
         catches_on = false;
         exploitation_rate = values;
     }
 
-    void catches_set(const Array<double,Sector>& values){
+    void catches_set(const Array<Scalar,Sector>& values){
         exploitation_on = true;
         catches_on = true;
         catches = values;
@@ -426,13 +434,35 @@ public:
     void check(void) const {
         recruitment_relation.check();
     }
+
+    /**
+     * Check parameters without throwing an exception (see `BevertonHolt::check(std::string*)`)
+     */
+    bool check(std::string* error) const {
+        return recruitment_relation.check(error);
+    }
    
     //! @}
 
     /**
      * Initialise various model variables based on current parameter values
+     *
+     * Throws an exception if parameters are invalid or the population does not
+     * converge to equilibrium.
      */
     void initialise(void){
+        std::string error;
+        if(not initialise(&error)) throw std::runtime_error(error);
+    }
+
+    /**
+     * Initialise without throwing an exception (see `Estimator::likelihood_checked()`)
+     *
+     * @param error String to write a description of any error to
+     * @returns Whether or not the model was initialised
+     */
+    bool initialise(std::string* error){
+        using std::exp;
 
         // Before checking, determine if parameterising by recruitment_relation.s0
         // or by recruitment_relation.r0 and set other accordingly
@@ -446,12 +476,13 @@ public:
             recruitment_relation.r0 = 1;
         }
         else {
-            throw std::runtime_error(str(boost::format(
+            if(error) *error = str(boost::format(
                 "Either `Matiri::Model::recruitment_relation.s0` <%s> or `Matiri::Model::recruitment_relation.r0` <%s> must be assigned a value greater than 0")
-                    %recruitment_relation.s0%recruitment_relation.r0));
+                    %recruitment_relation.s0%recruitment_relation.r0);
+            return false;
         }
 
-        check();
+        if(not check(error)) return false;
 
         for(auto sex : sexes){
             for(auto age : ages){
@@ -469,7 +500,9 @@ public:
                     selectivities(sector,sex,age) = selectivity_sex(sector,sex) * selectivity_age(sector,sex)(age_);
                 }
 
-                mortality_survivals(sex,age) = Population::Mortality::Rate().instantaneous(mortalities(sex,age)).survival();
+                // Equivalent to `Population::Mortality::Rate().instantaneous(mortalities(sex,age)).survival()`
+                // but differentiable
+                mortality_survivals(sex,age) = exp(-mortalities(sex,age));
             }
         }
 
@@ -485,10 +518,11 @@ public:
         recruitment_relation.off();
         exploitation_on = false;
         // Go to equilibrium
-        equilibrium();
+        bool converged = equilibrium(error);
         // Turn on recruitment relationship etc again
         recruitment_relation.on();
         exploitation_on = true;
+        if(not converged) return false;
 
         /**
          * Once the population has converged to unfished equilibrium, the virgin
@@ -499,7 +533,7 @@ public:
         }
         else {
             // Parameterised by B0 so scale everything up
-            double scaler = recruitment_relation.s0/biomass_spawning;
+            Scalar scaler = recruitment_relation.s0/biomass_spawning;
             recruitment_relation.r0 *= scaler;
             for(auto sex : sexes){
                 for(auto age : ages){
@@ -509,6 +543,7 @@ public:
             biomass *= scaler;
             biomass_spawning *= scaler;
         }
+        return true;
     }
 
     /**
@@ -546,7 +581,7 @@ public:
         if(exploitation_on){
             if(catches_on){
                 for(auto sector : sectors){
-                    double er = biomass_vulnerable(sector)>0?(catches(sector)/biomass_vulnerable(sector)):1;
+                    Scalar er = biomass_vulnerable(sector)>0?Scalar(catches(sector)/biomass_vulnerable(sector)):Scalar(1);
                     exploitation_rate(sector) = (er>exploitation_rate_max(sector))?exploitation_rate_max(sector):er;
                 } 
             }
@@ -558,7 +593,7 @@ public:
             // Pre-calculate the exploitation_survivals for each sex and age
             for(auto sex : sexes){
                 for(auto age : ages){
-                    double prod = 1;
+                    Scalar prod = 1;
                     for(auto sector : sectors){
                         prod *= (1 - exploitation_rate(sector) * selectivities(sector,sex,age));
                     }
@@ -567,9 +602,9 @@ public:
                 }
             }
         } else {
-            biomass_vulnerable = 0.0;
-            exploitation_rate = 0.0;
-            exploitation_survivals = 1.0;
+            biomass_vulnerable = Scalar(0);
+            exploitation_rate = Scalar(0);
+            exploitation_survivals = Scalar(1);
         }
 
         // Mortality and exploitation
@@ -583,7 +618,7 @@ public:
     void seed(void){
         // Seed the numbers at age
         for(auto sex : sexes){
-            double surviving = recruitment_relation.r0 * ((sex==0)?sex_ratio:(1-sex_ratio));
+            Scalar surviving = recruitment_relation.r0 * ((sex==0)?sex_ratio:Scalar(1-sex_ratio));
             for(auto age : ages){
                 surviving *= mortality_survivals(sex,age);
                 numbers(sex,age) = surviving;
@@ -595,6 +630,17 @@ public:
      * Move the population to a deterministic equilibrium 
      */
     void equilibrium(void){
+        std::string error;
+        if(not equilibrium(&error)) throw std::runtime_error(error);
+    }
+
+    /**
+     * Move the population to a deterministic equilibrium without throwing an exception
+     *
+     * @param error String to write a description of any error to
+     * @returns Whether or not the population converged
+     */
+    bool equilibrium(std::string* error){
         // Turn off recruitment variation
         bool recruitment_variation_on = recruitment_variation;
         recruitment_variation.off();
@@ -605,16 +651,26 @@ public:
         while(steps<steps_max){
             update();
 
-            double diff = fabs(biomass-biomass_prev)/biomass_prev;
+            double biomass_current = Math::Autodiff::value(biomass);
+            // Invalid values will never converge so stop early
+            if(not std::isfinite(biomass_current)){
+                steps = steps_max;
+                break;
+            }
+            double diff = fabs(biomass_current-biomass_prev)/biomass_prev;
             if(diff<0.00001 and steps>ages.size()) break;
-            biomass_prev = biomass;
+            biomass_prev = biomass_current;
 
             steps++;
         }
-        // Throw an error if there was no convergence
-        if(steps>steps_max) throw std::runtime_error("Did not converge");
         // Turn on recruitment deviation again
         if(recruitment_variation_on) recruitment_variation.on();
+        // Fail if there was no convergence
+        if(steps>=steps_max){
+            if(error) *error = "Did not converge";
+            return false;
+        }
+        return true;
     }
 }; // class Matiri
 
@@ -3,6 +3,9 @@
 #include <fstream>
 #include <array>
 
+#include <fsl/math/probability/likelihoods.hpp>
+#include <fsl/math/probability/multinomial.hpp>
+
 namespace Fsl {
 namespace Monitoring {
 namespace Composition {
@@ -33,19 +36,16 @@ public:
         for(unsigned int bin=0;bin<bins;bin++) expecteds[bin] = expected[bin];
     }
     
+    /**
+     * Simulate observed proportions from expected proportions
+     * using a multinomial with the sample's size
+     */
+    void simulate(void){
+        Math::Probability::Multinomial::random(expecteds.data(),bins,size,observeds.data());
+    }
+
     double likelihood(void) const {
-        double a = 0;
-        double b = 0;
-        double n_ = std::min(size,1000.0);
-        for(unsigned int bin=0;bin<bins;bin++) {
-            const double& o = observeds[bin];
-            const double& e = expecteds[bin];
-            double e_ = (1-e)*e+0.1/bins;
-            a += std::log(e_);
-            double c = -std::pow(o-e,2)/(2*e_/n_);
-            b += std::log(std::exp(c)+0.01);
-        }
-        return -(0.5*a-b);
+        return Math::Probability::Likelihoods::fournier(observeds.data(),expecteds.data(),bins,size);
     }
     
 };
@@ -26,6 +26,19 @@ public:
     Normal error_dist;
     Autocorrelation error_autocorr;
 
+    /**
+     * Pre-generated errors, refilled for a whole series at a time
+     */
+    std::vector<double> errors;
+    unsigned int errors_next = 0;
+
+    /**
+     * Autocorrelated, standard normal deviations (e.g. from `Math::Series::Arma`) to
+     * use instead of random errors. Consumed in order of updates and rewound by `initialise()`
+     * so that each candidate in a replicate gets identical observation error.
+     */
+    std::vector<double> tape;
+
 	template<class Mirror>
     void reflect(Mirror& mirror) {
         mirror
@@ -37,6 +50,8 @@ public:
 		catchability = 1;
 		error_dist = Normal(0, error);
 		error_autocorr = Autocorrelation(autocorr);
+		errors.clear();
+		errors_next = 0;
 	}
 
 	template<class Population, class Harvesting>
@@ -50,7 +65,17 @@ public:
         double cpue_acheived = cpue_apparent * catchability;
 
         // Add autocorrelated error
-        double cpue_observed = cpue_acheived * std::exp(error_autocorr(error_dist.random()));
+        if (not tape.empty()) {
+            if (errors_next >= tape.size()) throw std::runtime_error("`Cpue::update` : past end of tape");
+            series(time) = cpue_acheived * std::exp(error * tape[errors_next++]);
+            return;
+        }
+        if (errors_next >= errors.size()) {
+            errors.resize(Time::size());
+            error_dist.random(errors.size(), errors.data());
+            errors_next = 0;
+        }
+        double cpue_observed = cpue_acheived * std::exp(error_autocorr(errors[errors_next++]));
 
 		series(time) = cpue_observed;
 	}
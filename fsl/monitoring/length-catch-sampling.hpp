@@ -23,6 +23,12 @@ public:
 	 */
 	Array<double> fractions;
 
+	/**
+	 * Buffer of multiplicative errors for each cell, generated in
+	 * one call for each update
+	 */
+	std::vector<double> errors;
+
 	template<class Mirror>
     void reflect(Mirror& mirror) {
         mirror
@@ -51,14 +57,19 @@ public:
 		Array<double, Length> sample = 0;
 		double sum = 0;
 		unsigned int index = 0;
-		Math::Probability::Lognormal error(1, imprecision);
+		errors.resize(Sex::size() * Age::size() * Length::size());
+		if (imprecision > 0) {
+			Math::Probability::Lognormal error(1, imprecision);
+			error.random(errors.size(), errors.data());
+		}
+		else std::fill(errors.begin(), errors.end(), 1);
 		for (auto length : Length::levels) {
 			for (auto sex : Sex::levels) {
 				for (auto age : Age::levels) {
 					sample(length) += population.numbers(sex, age) * 
 									fractions[index] * 
 									harvesting.selectivities(sex, age) * 
-									(imprecision > 0 ? error.random() : 1);
+									errors[index];
 					index++;
 				}
 			}
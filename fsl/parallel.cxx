@@ -0,0 +1,52 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include <fsl/parallel.hpp>
+
+BOOST_AUTO_TEST_SUITE(parallel)
+
+using namespace Fsl;
+
+BOOST_AUTO_TEST_CASE(each){
+    std::vector<unsigned int> calls(1000,0);
+    Parallel::each(calls.size(),[&](unsigned int index){
+        calls[index]++;
+    },4);
+    for(auto count : calls) BOOST_REQUIRE_EQUAL(count,1u);
+
+    BOOST_CHECK_THROW(Parallel::each(100,[](unsigned int index){
+        if(index==50) throw std::runtime_error("fail");
+    },4),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(pool){
+    Parallel::Pool pool(4);
+    BOOST_CHECK_EQUAL(pool.size(),4u);
+    // Many calls reuse the same threads
+    std::vector<unsigned int> calls(8,0);
+    for(unsigned int call=0;call<10000;call++){
+        pool.each(calls.size(),[&](unsigned int index){
+            calls[index]++;
+        });
+    }
+    for(auto count : calls) BOOST_REQUIRE_EQUAL(count,10000u);
+
+    BOOST_CHECK_THROW(pool.each(100,[](unsigned int index){
+        if(index==50) throw std::runtime_error("fail");
+    }),std::runtime_error);
+
+    // Pool is still usable after an exception
+    unsigned int total = 0;
+    std::mutex mutex;
+    pool.each(100,[&](unsigned int index){
+        std::lock_guard<std::mutex> lock(mutex);
+        total += index;
+    });
+    BOOST_CHECK_EQUAL(total,4950u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
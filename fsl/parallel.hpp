@@ -0,0 +1,203 @@
+/*!
+ * @file parallel.hpp
+ * @brief Simple shared-memory parallelism
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Fsl {
+namespace Parallel {
+
+/**
+ * Get the number of threads to use
+ *
+ * @param requested Number of threads requested, 0 for the number of hardware threads
+ */
+inline unsigned int threads(unsigned int requested = 0){
+    if(requested>0) return requested;
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return hardware>0?hardware:1;
+}
+
+/**
+ * Call `function(index)` for each index in `[0,count)` using a number of threads
+ *
+ * Indices are handed out to threads dynamically so that uneven
+ * work loads are balanced. If any call throws an exception, remaining
+ * indices are abandoned and the first exception is rethrown in the calling thread.
+ *
+ * @param count    Number of indices
+ * @param function Function to call for each index
+ * @param threads  Number of threads, 0 for the number of hardware threads
+ */
+template<
+    class Function
+>
+void each(unsigned int count, Function function, unsigned int threads = 0){
+    threads = Parallel::threads(threads);
+    if(threads>count) threads = count;
+    if(threads<=1){
+        for(unsigned int index=0;index<count;index++) function(index);
+        return;
+    }
+
+    std::atomic<unsigned int> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto work = [&](void){
+        while(true){
+            unsigned int index = next++;
+            if(index>=count) break;
+            try {
+                function(index);
+            } catch(...){
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if(not error) error = std::current_exception();
+                next = count;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(unsigned int thread=1;thread<threads;thread++) pool.push_back(std::thread(work));
+    work();
+    for(auto& thread : pool) thread.join();
+
+    if(error) std::rethrow_exception(error);
+}
+
+/**
+ * A pool of persistent threads for repeatedly calling `function(index)` for each
+ * index in `[0,count)`
+ *
+ * Like `each()` but threads are started once, when the pool is constructed, and wait
+ * between calls rather than being started and joined for every call. Use it when `each()` would
+ * be called many times with little work per call (e.g. once per round of `Tempering`) so that
+ * thread start-up would dominate.
+ */
+class Pool {
+public:
+
+    /**
+     * Create a pool
+     *
+     * @param threads Number of threads, including the calling thread, 0 for the number of hardware threads
+     */
+    Pool(unsigned int threads = 0){
+        threads = Parallel::threads(threads);
+        for(unsigned int thread=1;thread<threads;thread++) threads_.push_back(std::thread([this](void){ loop_(); }));
+    }
+
+    ~Pool(void){
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for(auto& thread : threads_) thread.join();
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    /**
+     * Number of threads, including the calling thread
+     */
+    unsigned int size(void) const {
+        return threads_.size()+1;
+    }
+
+    /**
+     * Call `function(index)` for each index in `[0,count)` using the threads
+     * of the pool and the calling thread
+     *
+     * As for `each()`, indices are handed out dynamically and the first exception
+     * thrown is rethrown in the calling thread.
+     */
+    void each(unsigned int count, const std::function<void (unsigned int)>& function){
+        if(threads_.empty() or count<=1){
+            for(unsigned int index=0;index<count;index++) function(index);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            function_ = &function;
+            count_ = count;
+            next_ = 0;
+            error_ = nullptr;
+            busy_ = threads_.size();
+            generation_++;
+        }
+        start_.notify_all();
+        work_();
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            finish_.wait(lock,[this](void){ return busy_==0; });
+            function_ = nullptr;
+            error = error_;
+        }
+        if(error) std::rethrow_exception(error);
+    }
+
+private:
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable finish_;
+
+    /**
+     * Current call: function, number of indices, next index, first error,
+     * number of pool threads still working on it and a count of calls
+     */
+    const std::function<void (unsigned int)>* function_ = nullptr;
+    unsigned int count_ = 0;
+    std::atomic<unsigned int> next_;
+    std::exception_ptr error_;
+    unsigned int busy_ = 0;
+    unsigned long generation_ = 0;
+    bool stop_ = false;
+
+    void work_(void){
+        while(true){
+            unsigned int index = next_++;
+            if(index>=count_) break;
+            try {
+                (*function_)(index);
+            } catch(...){
+                std::lock_guard<std::mutex> lock(mutex_);
+                if(not error_) error_ = std::current_exception();
+                next_ = count_;
+            }
+        }
+    }
+
+    void loop_(void){
+        unsigned long seen = 0;
+        while(true){
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock,[&](void){ return stop_ or generation_!=seen; });
+                if(stop_) return;
+                seen = generation_;
+            }
+            work_();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if(--busy_==0) finish_.notify_one();
+            }
+        }
+    }
+};
+
+} // namespace Parallel
+} // namespace Fsl
@@ -3,6 +3,8 @@
 #include <stencila/structure.hpp>
 using Stencila::Structure;
 
+#include <fsl/math/kernels/transcendental.hpp>
+
 
 namespace Fsl {
 namespace Population {
@@ -10,25 +12,43 @@ namespace Growth {
 
 /*!
 von Bertallanfy growth function
+
+@tparam Scalar Type of parameters and values (e.g. `double` or an automatic differentiation type)
 */
-class VonBert : public Structure<VonBert> {
+template<
+    typename Scalar = double
+>
+class BasicVonBert : public Structure<BasicVonBert<Scalar>> {
 public:
 
-    double k;
-    double linf;
-    double t0;
+    Scalar k;
+    Scalar linf;
+    Scalar t0;
 
-    VonBert(){
+    BasicVonBert(){
     }
 
-    VonBert(double k, double linf, double t0=0):
+    BasicVonBert(Scalar k, Scalar linf, Scalar t0=0):
     	k(k),
     	linf(linf),
     	t0(t0){
 	}
 
-    double value(const double& age) const {
-        return linf*(1-std::exp(-k*(age-t0)));
+    Scalar value(const Scalar& age) const {
+        using std::exp;
+        return linf*(1-exp(-k*(age-t0)));
+    }
+
+    /**
+     * Values at a number of ages (for `double` parameters)
+     */
+    void value(const double* ages, double* lengths, std::size_t size) const {
+        const double k_ = k;
+        const double linf_ = linf;
+        const double t0_ = t0;
+        for(std::size_t index=0;index<size;index++){
+            lengths[index] = linf_*(1-Math::Kernels::exp(-k_*(ages[index]-t0_)));
+        }
     }
 
     template<class Mirror>
@@ -41,6 +61,8 @@ public:
     }
 };
 
+typedef BasicVonBert<> VonBert;
+
 }
 }
 }
@@ -0,0 +1,61 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/population/recruitment/autocorrelated.hpp>
+
+BOOST_AUTO_TEST_SUITE(autocorrelated)
+
+using namespace Fsl::Population::Recruitment;
+using Fsl::Math::Probability::Lognormal;
+using Fsl::Math::Probability::Generator;
+
+BOOST_AUTO_TEST_CASE(bulk){
+    // Multipliers for a whole projection, pre-generated and drawn one at a time,
+    // are identical to those drawn in bulk
+    const std::size_t years = 37;
+    Autocorrelated<Lognormal> scalar(0.6,0);
+    Generator.seed(42);
+    scalar.prepare(years);
+    std::vector<double> expected(years);
+    for(auto& multiplier : expected) multiplier = scalar.random();
+
+    Autocorrelated<Lognormal> bulk(0.6,0);
+    Generator.seed(42);
+    std::vector<double> multipliers(years);
+    bulk.random(years,multipliers.data());
+    for(std::size_t year=0;year<years;year++) BOOST_CHECK_EQUAL(multipliers[year],expected[year]);
+
+    // Beyond the prepared block further blocks are generated
+    for(int year=0;year<100;year++) BOOST_CHECK(scalar.random()>0);
+}
+
+BOOST_AUTO_TEST_CASE(tape){
+    std::vector<double> deviations = {0.5,-1,2,0};
+    Autocorrelated<Lognormal> recruitment(0.6,0);
+    recruitment.tape(deviations);
+    std::vector<double> scalar;
+    for(std::size_t index=0;index<deviations.size();index++) scalar.push_back(recruitment.random());
+    BOOST_CHECK_THROW(recruitment.random(),std::runtime_error);
+
+    recruitment.rewind();
+    std::vector<double> bulk(deviations.size());
+    recruitment.random(bulk.size(),bulk.data());
+    for(std::size_t index=0;index<deviations.size();index++){
+        BOOST_CHECK_EQUAL(bulk[index],scalar[index]);
+        BOOST_CHECK_CLOSE(scalar[index],std::exp(0.6*deviations[index]-0.5*0.36),1e-12);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(mean){
+    // Bias corrected so that the mean multiplier is one
+    Autocorrelated<Lognormal> recruitment(0.6,0);
+    std::vector<double> multipliers(200000);
+    recruitment.random(multipliers.size(),multipliers.data());
+    double sum = 0;
+    for(auto multiplier : multipliers) sum += multiplier;
+    BOOST_CHECK_SMALL(sum/multipliers.size()-1,0.01);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
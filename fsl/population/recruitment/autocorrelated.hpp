@@ -1,8 +1,12 @@
 #pragma once
 
+#include <stdexcept>
+#include <vector>
+
 #include <fsl/math/probability/normal.hpp>
 #include <fsl/math/probability/lognormal.hpp>
 #include <fsl/math/series/autocorrelation.hpp>
+#include <fsl/math/kernels/transcendental.hpp>
 
 namespace Fsl {
 namespace Population {
@@ -20,6 +24,21 @@ class Autocorrelated<
 private:
     Math::Series::Autocorrelation autocorrelation;
 
+    /**
+     * Pre-generated standard normal deviates for `random()`, generated
+     * in blocks of `block_` (see `prepare()`)
+     */
+    std::vector<double> deviates_;
+    std::size_t next_ = 0;
+    std::size_t block_ = 64;
+
+    /**
+     * Autocorrelated standard normal deviations to use instead of
+     * random draws (see `tape()`)
+     */
+    std::vector<double> tape_;
+    std::size_t tape_next_ = 0;
+
 public:
     double sd;
     double autocor;
@@ -28,13 +47,72 @@ public:
         sd(sd_),
         autocor(autocor_){}
 
+    /**
+     * Use a tape of autocorrelated, standard normal deviations (e.g. from `Math::Series::Arma`)
+     * instead of random draws. `autocor` is ignored while a tape is in use. Calling this
+     * again, with the same tape, rewinds so that each candidate in a replicate gets
+     * identical recruitment variation. Pass an empty tape to revert to random draws.
+     */
+    void tape(const std::vector<double>& deviations) {
+        tape_ = deviations;
+        tape_next_ = 0;
+    }
+
+    /**
+     * Rewind to the start of the tape
+     */
+    void rewind(void) {
+        tape_next_ = 0;
+    }
+
+    /**
+     * Pre-generate the deviates for the next `size` calls to `random()` (e.g. the number
+     * of years in a projection) in a single bulk draw. Later blocks are the same size. Without
+     * this, blocks of 64 are used: enough for most projections while not generating many more
+     * deviates than are used in short runs (e.g. a single year per model evaluation).
+     */
+    void prepare(std::size_t size) {
+        block_ = size>0?size:1;
+        generate_();
+    }
+
     double random(void) {
-        Math::Probability::Normal normal(0,sd);
-        double deviation = normal.random();
+        if(not tape_.empty()){
+            if(tape_next_>=tape_.size()) throw std::runtime_error("`Autocorrelated::random` : past end of tape");
+            return Math::Kernels::exp(sd*tape_[tape_next_++]-0.5*sd*sd);
+        }
+        if(next_>=deviates_.size()) generate_();
+        double deviation = sd*deviates_[next_++];
         deviation = autocorrelation(deviation);
-        double multiplier = std::exp(deviation-0.5*sd*sd);
+        // Same kernel as the bulk version so that results are identical
+        double multiplier = Math::Kernels::exp(deviation-0.5*sd*sd);
         return multiplier;
     }
+
+    /**
+     * Fill `multipliers` with the next `size` multipliers (e.g. for a whole projection).
+     * Given the same deviates, these are identical to those from `size` calls to `random()`.
+     */
+    void random(std::size_t size, double* multipliers) {
+        if(not tape_.empty()){
+            for(std::size_t index=0;index<size;index++) multipliers[index] = random();
+            return;
+        }
+        Math::Probability::Samplers::normal(Math::Probability::Generator,multipliers,size);
+        for(std::size_t index=0;index<size;index++) multipliers[index] *= sd;
+        autocorrelation(multipliers,size);
+        double bias = 0.5*sd*sd;
+        for(std::size_t index=0;index<size;index++) multipliers[index] -= bias;
+        Math::Kernels::exp(multipliers,multipliers,size);
+    }
+
+private:
+
+    void generate_(void) {
+        deviates_.resize(block_);
+        Math::Probability::Samplers::normal(Math::Probability::Generator,deviates_.data(),deviates_.size());
+        next_ = 0;
+    }
 };
 
 }
@@ -12,16 +12,46 @@ using namespace Fsl::Population::Recruitment;
 BOOST_AUTO_TEST_CASE(simple){
 
     BevertonHolt bh;
-    bh.s0(327070)
-      .r0(580823750)
-      .steepness(0.746157);
+    bh.s0 = 327070;
+    bh.r0 = 580823750;
+    bh.h = 0.746157;
 
     //Check that at virgin stock size get virgin recruitment
-    BOOST_CHECK_CLOSE(bh(bh.s0()),bh.r0(),0.0001);
+    BOOST_CHECK_CLOSE(bh(bh.s0),bh.r0,0.0001);
 
     //Check that at 20% of virgin get steepness fraction of r0
-    BOOST_CHECK_CLOSE(bh(bh.s0()*0.2),bh.r0()*bh.steepness(),0.0001);
+    BOOST_CHECK_CLOSE(bh(bh.s0*0.2),bh.r0*bh.h,0.0001);
 
 }
 
+BOOST_AUTO_TEST_CASE(check){
+    BevertonHolt bh;
+    bh.s0 = 1000;
+    bh.r0 = 1e6;
+    bh.h = 0.8;
+    BOOST_CHECK(bh.check(nullptr));
+    std::string error;
+    BOOST_CHECK(bh.check(&error));
+    BOOST_CHECK_EQUAL(error,"");
+    BOOST_CHECK_NO_THROW(bh.check());
+
+    // Invalid values are rejected without a description unless one is asked for
+    bh.h = 0.2;
+    BOOST_CHECK(not bh.check(nullptr));
+    BOOST_CHECK(not bh.check(&error));
+    BOOST_CHECK(error.find("`BevertonHolt::h` has invalid value")!=std::string::npos);
+    BOOST_CHECK_THROW(bh.check(),std::runtime_error);
+
+    bh.h = 0.8;
+    bh.s0 = NAN;
+    BOOST_CHECK(not bh.check(nullptr));
+    BOOST_CHECK(not bh.check(&error));
+    BOOST_CHECK(error.find("`BevertonHolt::s0` has invalid value")!=std::string::npos);
+
+    bh.s0 = 1000;
+    bh.r0 = -1;
+    BOOST_CHECK(not bh.check(&error));
+    BOOST_CHECK(error.find("`BevertonHolt::r0` has invalid value")!=std::string::npos);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -12,35 +12,57 @@ namespace Recruitment {
 /**
 Beverton-Holt stock recruitment relationship parameterised using steepness and
 pristine stock and recruitment levels
+
+@tparam Scalar Type of parameters and values (e.g. `double` or an automatic differentiation type)
 */
-class BevertonHolt : public Structure<BevertonHolt> {
+template<
+    typename Scalar = double
+>
+class BasicBevertonHolt : public Structure<BasicBevertonHolt<Scalar>> {
 public:
 
-    double r0;
-    double s0;
-    double h;
+    Scalar r0;
+    Scalar s0;
+    Scalar h;
 
-    void check(void) const {
-        if(not std::isfinite(r0) or r0 <= 0){
-            throw std::runtime_error(str(boost::format("`BevertonHolt::r0` has invalid value.\n  r0: %s")%r0));
+    /**
+     * Check that parameters are valid without throwing an exception
+     * (see `Estimator::likelihood_checked()`)
+     *
+     * @param error String to write a description of any error to
+     * @returns Whether or not parameters are valid
+     */
+    bool check(std::string* error) const {
+        using std::isfinite;
+        if(not isfinite(r0) or r0 <= 0){
+            if(error) *error = str(boost::format("`BevertonHolt::r0` has invalid value.\n  r0: %s")%r0);
+            return false;
         }
-        if(not std::isfinite(s0) or s0 <= 0){
-            throw std::runtime_error(str(boost::format("`BevertonHolt::s0` has invalid value.\n s0: %s")%s0));
+        if(not isfinite(s0) or s0 <= 0){
+            if(error) *error = str(boost::format("`BevertonHolt::s0` has invalid value.\n s0: %s")%s0);
+            return false;
         }
-        if(not std::isfinite(h) or h<=0.2 or h>1){
-            throw std::runtime_error(str(boost::format("`BevertonHolt::h` has invalid value.\n h: %s")%h));
+        if(not isfinite(h) or h<=0.2 or h>1){
+            if(error) *error = str(boost::format("`BevertonHolt::h` has invalid value.\n h: %s")%h);
+            return false;
         }
+        return true;
+    }
+
+    void check(void) const {
+        std::string error;
+        if(not check(&error)) throw std::runtime_error(error);
     }
 
-    double alpha(void) const {
+    Scalar alpha(void) const {
         return 4*r0*h/(5*h-1);
     }
 
-    double beta(void) const {
+    Scalar beta(void) const {
         return -(s0*h-s0)/(5*h-1);
     }
 
-    double operator()(const double& stock) {
+    Scalar operator()(const Scalar& stock) {
         return 4*h*r0*stock/((5*h-1)*stock+s0*(1-h));
     }
 
@@ -54,6 +76,8 @@ public:
     }
 };
 
+typedef BasicBevertonHolt<> BevertonHolt;
+
 }
 }
 }
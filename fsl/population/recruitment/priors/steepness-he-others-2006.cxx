@@ -30,3 +30,17 @@ BOOST_AUTO_TEST_CASE(examples){
 		}
 	}	
 }
+
+BOOST_AUTO_TEST_CASE(tabulated){
+	SteepnessHe2006 prior;
+	const Fsl::Math::Probability::Tabulated& tabulated = prior.tabulated(0.3,0.6);
+	BOOST_CHECK_EQUAL(tabulated.values().size(),81u);
+	BOOST_CHECK_EQUAL(tabulated.quantile(0),0.2);
+	BOOST_CHECK_EQUAL(tabulated.quantile(1),1);
+	// Tables are cached for each cell
+	BOOST_CHECK_EQUAL(&tabulated,&prior.tabulated(0.31,0.61));
+	for(int draw=0;draw<1000;draw++){
+		double steepness = prior.random(0.3,0.6);
+		BOOST_REQUIRE(steepness>=0.2 and steepness<=1);
+	}
+}
@@ -1,15 +1,13 @@
 #pragma once
 
-#include <boost/foreach.hpp>
-
-#include <fsl/math/probability/uniform.hpp>
+#include <fsl/math/probability/tabulated.hpp>
 
 namespace Fsl {
 namespace Population {
 namespace Recruitment {
 namespace Priors {
 	
-using Fsl::Math::Probability::Uniform;
+using Fsl::Math::Probability::Tabulated;
 
 /*!
 
@@ -25,8 +23,26 @@ public:
 		double Omega2;
 		double Omega3;
 	};
+
+	/*!
+	The cell of the table (10 classes of natural mortality by 8 classes of sigma) for
+	given natural mortality and sigma
+	*/
+	static int cell(const double& mort, const double& sigma) {
+		const double mortWidth = 0.05;
+		const double sigmaWidth = 0.2;
+		int mortClass = std::min(std::max(0,int((mort+mortWidth*0.5)/mortWidth)-1),9);
+		int sigmaClass = std::min(std::max(0,int((sigma+sigmaWidth*0.5)/sigmaWidth)-1),7);
+		return sigmaClass * 10 + mortClass;
+	}
+
 	Parameters parameters(const double& mort, const double& sigma) const{
 		//Returns the parameter values for a prioir on steepness given natural mortality and sigma
+		return parameters(cell(mort,sigma));
+	}
+
+	static Parameters parameters(int cell) {
+		//Returns the parameter values for a cell of the table
 
 		//Table 1 from He et al (2006).
 		//Note that the value with "/*Iterpolated*/" next to it was missing in the original table and is interpolated from the omega1 values 'above' and 'below' it in the table
@@ -58,11 +74,7 @@ public:
 			3.90900e+1,2.50300e+1,1.72200e+1,1.32200e+1,1.10800e+1,1.02500e+1,1.07500e+1,1.29000e+1,1.68500e+1,1.68500e+1,
 			3.00100e-2,8.90000e-3,4.92300e-3,3.34000e-3,1.97100e-3,8.68600e-4,5.31500e-5,7.90000e-7,1.00000e-8,1.00000e-8
 		};
-		const double mortWidth = 0.05;
-		const double sigmaWidth = 0.2;
-		int mortClass = std::min(std::max(0,int((mort+mortWidth*0.5)/mortWidth)-1),9);
-		int sigmaClass = std::min(std::max(0,int((sigma+sigmaWidth*0.5)/sigmaWidth)-1),7);
-		int start = sigmaClass * 30 + mortClass;
+		int start = (cell/10) * 30 + cell%10;
 
 		//Note that in the table caption the authors say that the parameters are in the order omega1,omega2,omega3
 		//However, if one assumes this order you don't get sensible results. If one assumes the order omega1,omega3,omega2 do get sensible priors
@@ -73,7 +85,7 @@ public:
 		return parameters;
 	}
 
-	double relative(const double& steepness, const Parameters& pars) const {
+	static double relative(const double& steepness, const Parameters& pars) {
 		//Gives the *relative* probability of a given steepness, given the parameters of the prior
 		const double o1 = pars.Omega1;
 		const double o2 = pars.Omega2;
@@ -82,53 +94,60 @@ public:
 	}
 	
 	std::vector<std::pair<double,double>> densities(const double& mortality,const double&sigma) const {
-		Parameters pars = parameters(mortality,sigma);
-		std::vector<std::pair<double,double>> densities;
-		double sum = 0;
-		double step = 0.01;
-		for(double steepness=0.2;steepness<=1;steepness+=step){
-			double probability = relative(steepness,pars);
-			densities.push_back(std::pair<double,double>(steepness,probability));
-			sum += probability * step;
-		}
-		//Normalise so that integral is 1
-		typedef std::pair<double,double> Density;
-		BOOST_FOREACH(Density& density,densities) density.second /= sum;
-		return densities;
+		return cached_(cell(mortality,sigma)).densities;
+	}
+
+	/*!
+	The tabulated distribution of steepness for natural mortality and sigma
+	*/
+	const Tabulated& tabulated(const double& mortality,const double&sigma) const {
+		return cached_(cell(mortality,sigma)).tabulated;
 	}
 
 	double random(const double& mortality,const double&sigma) const {
-		static Uniform uniform(0,1);
-
-		const double cumulativeProbsStep = 0.01;
-		const int cumulativeProbsSteps = 81;
-		double cumulativeProbs[81];
-		Parameters pars = parameters(mortality,sigma);
-		double cumul = 0;
-		for(int step=0;step<cumulativeProbsSteps;step++){
-			double steepness=0.2+step*cumulativeProbsStep;
-			cumul += relative(steepness,pars);
-			cumulativeProbs[step] = cumul;
-		}
-		
-		//Normalise
-		for(int step=0;step<cumulativeProbsSteps;step++) cumulativeProbs[step] /= cumul;
-
-		double p = uniform.random();
-		int step = 0;
-		while(step<cumulativeProbsSteps){
-			if(cumulativeProbs[step]>=p) break;
-			step++;
-		}
-		if(step==0) return 0.2;
-		if(step==cumulativeProbsSteps) return 1;
-		
-		//Intepolate
-		double phi = cumulativeProbs[step];
-		double steephi = 0.2+step*cumulativeProbsStep;
-		double plo = cumulativeProbs[step-1];
-		double steeplo = 0.2+(step-1)*cumulativeProbsStep;
-		return steeplo+(steephi-steeplo)*(p-plo)/(phi-plo);
+		return tabulated(mortality,sigma).random();
+	}
+
+private:
+
+	/*!
+	Normalised densities, and cumulative probabilities for random draws, for a
+	cell of the table. These depend only on the cell so are calculated once for all cells.
+	*/
+	struct Cached_ {
+		std::vector<std::pair<double,double>> densities;
+		Tabulated tabulated;
+	};
+
+	static const Cached_& cached_(int cell) {
+		static const std::vector<Cached_> cells = [](){
+			std::vector<Cached_> cells(80);
+			for(int cell=0;cell<80;cell++){
+				Parameters pars = parameters(cell);
+
+				std::vector<std::pair<double,double>>& densities = cells[cell].densities;
+				double sum = 0;
+				double step = 0.01;
+				for(double steepness=0.2;steepness<=1;steepness+=step){
+					double probability = relative(steepness,pars);
+					densities.push_back(std::pair<double,double>(steepness,probability));
+					sum += probability * step;
+				}
+				//Normalise so that integral is 1
+				for(auto& density : densities) density.second /= sum;
+
+				const int steps = 81;
+				std::vector<double> steepnesses(steps);
+				std::vector<double> relatives(steps);
+				for(int step=0;step<steps;step++){
+					steepnesses[step] = 0.2+step*0.01;
+					relatives[step] = relative(steepnesses[step],pars);
+				}
+				cells[cell].tabulated = Tabulated(steepnesses,relatives);
+			}
+			return cells;
+		}();
+		return cells[cell];
 	}
 };
 
@@ -44,9 +44,7 @@ public:
     }
 
     double operator()(const double& spawners) {
-        boost::normal_distribution<> distr(0,1);
-        boost::variate_generator<boost::mt19937&,decltype(distr)> randomVariate(generator,distr);
-        double deviation = randomVariate()*sd;
+        double deviation = Math::Probability::Samplers::normal(generator)*sd;
         
         deviation = autocorrelation(deviation);
         double multiplier = std::exp(deviation-0.5*sd*sd);
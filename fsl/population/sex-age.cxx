@@ -0,0 +1,95 @@
+#ifdef FSL_TEST_SINGLE
+    #define BOOST_TEST_MODULE tests
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <fsl/population/sex-age.hpp>
+
+BOOST_AUTO_TEST_SUITE(sex_age)
+
+using namespace Fsl::Population;
+using Fsl::Math::Autodiff::Reverse;
+
+struct Sex : Dimension<Sex,2>{
+    Sex(void):Dimension<Sex,2>("sex"){}
+    static const char* name(void) { return "sex"; }
+};
+
+struct Age : Dimension<Age,20>{
+    Age(void):Dimension<Age,20>("age"){}
+    static const char* name(void) { return "age"; }
+};
+
+/**
+ * Spawning biomass and total numbers after a number of deterministic years
+ * starting from unfished numbers at age
+ */
+template<typename Scalar>
+Scalar dynamics(const std::vector<Scalar>& x){
+    SexAge<Sex,Age,Scalar> population;
+    population.stock_recruits.r0 = 1e6;
+    population.stock_recruits.s0 = 5000;
+    population.stock_recruits.h = x[0];
+    for(auto sex : Sex::levels){
+        population.mortality_sex(sex) = x[1];
+        population.length_age(sex).k = x[2];
+        population.length_age(sex).linf = x[3];
+        population.length_age(sex).t0 = 0;
+        population.length_age(sex).cv = x[4];
+        population.weight_length(sex).a = 1e-5;
+        population.weight_length(sex).b = 3;
+        population.maturity_age(sex).inflection = x[5];
+        population.maturity_age(sex).steepness = 2;
+    }
+    population.recruits_vary = false;
+    population.initialise();
+    population.seed();
+    for(int year=0;year<30;year++) population.update();
+    using std::log;
+    return log(population.biomass_spawning()) + 1e-7*population.numbers_total();
+}
+
+BOOST_AUTO_TEST_CASE(gradient){
+    std::vector<double> x = {0.8,0.2,0.25,60,0.1,5};
+
+    std::vector<double> gradient;
+    double value = Fsl::Math::Autodiff::gradient(dynamics<Reverse>,x,gradient);
+    BOOST_CHECK_CLOSE(value,dynamics<double>(x),1e-10);
+
+    // Central finite differences
+    for(unsigned int index=0;index<x.size();index++){
+        double h = 1e-5*std::fabs(x[index]);
+        std::vector<double> up = x;
+        up[index] += h;
+        std::vector<double> down = x;
+        down[index] -= h;
+        double expected = (dynamics<double>(up)-dynamics<double>(down))/(2*h);
+        BOOST_CHECK_CLOSE(gradient[index],expected,1e-4);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pristine){
+    // Equilibrium iterations run with automatic differentiation types
+    // and are scaled to unfished spawning biomass
+    SexAge<Sex,Age,Reverse> population;
+    population.stock_recruits.s0 = 5000;
+    population.stock_recruits.h = 0.8;
+    for(auto sex : Sex::levels){
+        population.length_age(sex).k = 0.25;
+        population.length_age(sex).linf = 60;
+        population.length_age(sex).t0 = 0;
+        population.length_age(sex).cv = 0.1;
+        population.weight_length(sex).a = 1e-5;
+        population.weight_length(sex).b = 3;
+        population.maturity_age(sex).inflection = 5;
+        population.maturity_age(sex).steepness = 2;
+    }
+    population.initialise();
+    std::string error;
+    BOOST_CHECK(population.pristine(&error));
+    // Within the convergence tolerance of the equilibrium
+    BOOST_CHECK_CLOSE(population.depletion().value(),1,1e-3);
+    Fsl::Math::Autodiff::Tape::current().clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
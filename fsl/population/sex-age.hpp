@@ -33,12 +33,20 @@ using Fsl::Math::Functions::Power;
 #include <fsl/math/functions/logistic.hpp>
 using Fsl::Math::Functions::Logistic;
 
+#include <fsl/math/autodiff/reverse.hpp>
+
 
 namespace Fsl {
 namespace Population {
 
-template<class Sexes, class Ages>
-class SexAge : public Structure< SexAge<Sexes, Ages> > {
+/**
+ * Sex and age structured population
+ *
+ * @tparam Scalar Type of parameters and state (e.g. `double` or `Math::Autodiff::Reverse`
+ *                for exact derivatives of model outputs with respect to parameters)
+ */
+template<class Sexes, class Ages, typename Scalar = double>
+class SexAge : public Structure< SexAge<Sexes, Ages, Scalar> > {
   public:
 
     const Sexes sexes = Sexes::levels;
@@ -53,7 +61,7 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Numbers by sex and age
      */
-    Array<double, Sexes, Ages> numbers = 0;
+    Array<Scalar, Sexes, Ages> numbers = Scalar(0);
 
     /**
      * @}
@@ -68,7 +76,7 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * BevertonHolt stock-recruitment relation
      */
-    BevertonHolt stock_recruits;
+    Recruitment::BasicBevertonHolt<Scalar> stock_recruits;
 
     /**
      * Lognormal recruitment variation
@@ -78,7 +86,7 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Spawning biomass at last update
      */
-    double biomass_spawning_last = 0;
+    Scalar biomass_spawning_last = 0;
 
     /**
      * Should the number of recruits be related to the number of spawners?
@@ -99,17 +107,17 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Deterministic recruitment at last update
      */
-    double recruits_determ = 0;
+    Scalar recruits_determ = 0;
 
     /**
      * Recruitment deviation (multiplier) at last update
      */
-    double recruits_deviation = 1;
+    Scalar recruits_deviation = 1;
 
     /**
      * Total number of recruits at last update
      */
-    double recruits = 0;
+    Scalar recruits = 0;
 
     /**
      * @}
@@ -124,12 +132,12 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Constant natural mortality by sex
      */
-    Array<double, Sexes> mortality_sex = 0.1;
+    Array<Scalar, Sexes> mortality_sex = Scalar(0.1);
 
     /**
      * Survivals at sex and age
      */
-    Array<double, Sexes, Ages> survivals;
+    Array<Scalar, Sexes, Ages> survivals;
 
     /**
      * @}
@@ -144,13 +152,13 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Length at age relation. vonBertallanfy with a normal distribution
      */
-    struct LengthAge : VonBert {
-        double cv;
+    struct LengthAge : Growth::BasicVonBert<Scalar> {
+        Scalar cv;
 
-        Normal distribution(const double& age){
-            auto mean = value(age);
-            auto sd = mean * cv;
-            return Normal(mean,sd);
+        Math::Probability::BasicNormal<Scalar> distribution(const Scalar& age){
+            Scalar mean = this->value(age);
+            Scalar sd = mean * cv;
+            return Math::Probability::BasicNormal<Scalar>(mean,sd);
         }
 
     };
@@ -163,7 +171,7 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Length at age distibutions for each sex and age
      */
-    Array<Normal, Sexes, Ages> lengths;
+    Array<Math::Probability::BasicNormal<Scalar>, Sexes, Ages> lengths;
 
     /**
      * @}
@@ -178,12 +186,12 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Weight at age reltion for each sex
      */
-    Array<Power, Sexes> weight_length;
+    Array<Math::Functions::BasicPower<Scalar>, Sexes> weight_length;
     
     /**
      * Mean weight at age for each sex
      */
-    Array<double, Sexes, Ages> weights;
+    Array<Scalar, Sexes, Ages> weights;
 
     /**
      * @}
@@ -198,12 +206,12 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Maturity at age relation for each sex
      */
-    Array<Logistic, Sexes> maturity_age;
+    Array<Math::Functions::BasicLogistic<Scalar>, Sexes> maturity_age;
 
     /**
      * Proportion mature by sex and age
      */
-    Array<double, Sexes, Ages> maturities;
+    Array<Scalar, Sexes, Ages> maturities;
 
     /**
      * @}
@@ -233,6 +241,7 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
      * Initialise the model
      */
     void initialise(void) {
+        using std::exp;
         for (auto sex : Sexes::levels) {
             for (auto age : Ages::levels) {
                 auto years = age.index() + 0.5;
@@ -245,7 +254,7 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
 
                 maturities(sex, age) = maturity_age(sex).value(years);
 
-                survivals(sex, age) = std::exp(-mortality_sex(sex));
+                survivals(sex, age) = exp(-mortality_sex(sex));
             }
         }
     }
@@ -285,9 +294,9 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
 
     void seed(void){
         // Seed the numbers at age
-        auto sex_ratio = 1/Sexes::levels.size();
+        double sex_ratio = 1.0/Sexes::levels.size();
         for (auto sex : Sexes::levels) {
-            double surviving = stock_recruits.r0 * sex_ratio;
+            Scalar surviving = stock_recruits.r0 * sex_ratio;
             for (auto age : Ages::levels) {
                 surviving *= survivals(sex, age);
                 numbers(sex, age) = surviving;
@@ -299,6 +308,18 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
      * Move the population to a deterministic equilibrium 
      */
     void equilibrium(void){
+        std::string error;
+        if(not equilibrium(&error)) throw std::runtime_error(error);
+    }
+
+    /**
+     * Move the population to a deterministic equilibrium without throwing an exception
+     * (see `Estimator::likelihood_checked()`)
+     *
+     * @param error String to write a description of any error to
+     * @returns Whether or not the population converged
+     */
+    bool equilibrium(std::string* error){
         // Turn off recruitment variation
         auto recruits_vary_current = recruits_vary;
         recruits_vary = false;
@@ -309,21 +330,39 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
         while(steps<steps_max){
             update();
 
-            double diff = fabs(biomass_spawning_last-biomass_spawning_prev)/biomass_spawning_prev;
+            double biomass_spawning_current = Math::Autodiff::value(biomass_spawning_last);
+            // Invalid values will never converge so stop early
+            if(not std::isfinite(biomass_spawning_current)){
+                steps = steps_max;
+                break;
+            }
+            double diff = fabs(biomass_spawning_current-biomass_spawning_prev)/biomass_spawning_prev;
             if(diff<1e-6 and steps > age_max) break;
-            biomass_spawning_prev = biomass_spawning_last;
+            biomass_spawning_prev = biomass_spawning_current;
 
             //std::cout << steps << "\t" << biomass_spawning_last << "\t" << diff << std::endl;
 
             steps++;
         }
-        // Throw an error if there was no convergence
-        if(steps>=steps_max) throw std::runtime_error("Did not converge");
         // Turn on recruitment variation again
         recruits_vary = recruits_vary_current;
+        // Fail if there was no convergence
+        if(steps>=steps_max){
+            if(error) *error = "Did not converge";
+            return false;
+        }
+        return true;
     }
 
     void pristine(void){
+        std::string error;
+        if(not pristine(&error)) throw std::runtime_error(error);
+    }
+
+    /**
+     * Initialise to pristine without throwing an exception (see `equilibrium(std::string*)`)
+     */
+    bool pristine(std::string* error){
         /**
          * The fish population is initialised to an unfished state
          * by iterating with virgin recruitment until it reaches equibrium
@@ -336,16 +375,17 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
         auto recruits_related_current = recruits_related;
         recruits_related = false;
         // Go to equilibrium
-        equilibrium();
+        bool converged = equilibrium(error);
         // Turn on recruitment relationship again
         recruits_related = recruits_related_current;
+        if(not converged) return false;
 
         /**
          * Once the population has converged to unfished equilibrium, the virgin
          * spawning biomass, or the virgin recruitment, can be set.
          */
         // Parameterised by B0 so scale everything up
-        double scaler = stock_recruits.s0/biomass_spawning_last;
+        Scalar scaler = stock_recruits.s0/biomass_spawning_last;
         stock_recruits.r0 *= scaler;
         for(auto sex : Sexes::levels){
             for(auto age : Ages::levels){
@@ -353,20 +393,21 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
             }
         }
         biomass_spawning_last *= scaler;
+        return true;
     }
 
     /**
      * Total numbers
      */
-    double numbers_total(void){
+    Scalar numbers_total(void){
         return sum(numbers);
     }
 
     /**
      * Total biomass
      */
-    double biomass_total(void){
-        double biomass = 0;
+    Scalar biomass_total(void){
+        Scalar biomass = 0;
         for(auto sex : Sexes::levels){
             for(auto age : Ages::levels){
                 biomass += numbers(sex, age) * weights(sex, age);
@@ -379,8 +420,8 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Spawning biomass
      */
-    double biomass_spawning(void) const {
-        double biomass = 0;
+    Scalar biomass_spawning(void) const {
+        Scalar biomass = 0;
         for(auto sex : Sexes::levels){
             for(auto age : Ages::levels){
                 biomass += numbers(sex, age) * weights(sex, age) * maturities(sex, age);
@@ -393,7 +434,7 @@ class SexAge : public Structure< SexAge<Sexes, Ages> > {
     /**
      * Stock depletion
      */
-    double depletion (void) const {
+    Scalar depletion (void) const {
         return biomass_spawning()/stock_recruits.s0;
     }
 